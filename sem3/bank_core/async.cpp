@@ -0,0 +1,108 @@
+// async.cpp
+#include "async.h"
+
+namespace core {
+
+// обёртка для Spawn: стартует сразу, уничтожается сама по завершении
+struct Executor::Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+Executor::Detached Executor::Start(Executor& exec, Task<void> task) {
+    co_await exec.Schedule();
+    std::exception_ptr error;
+    try {
+        co_await task;
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    exec.Finished(error);
+}
+
+void Executor::Finished(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(m);
+    if (error && !firstError) firstError = error;
+    --running;
+    if (running == 0) wake.notify_all();
+}
+
+void Executor::Post(std::coroutine_handle<> h) {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        ready.push_back(h);
+    }
+    wake.notify_one();
+}
+
+void Executor::Spawn(Task<void> task) {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        ++running;
+    }
+    Start(*this, std::move(task));
+}
+
+void Executor::Run() {
+    while (true) {
+        std::coroutine_handle<> next;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            wake.wait(lock, [this] { return !ready.empty() || running == 0; });
+            if (ready.empty()) break;
+            next = ready.front();
+            ready.pop_front();
+        }
+        next.resume();
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        error = std::exchange(firstError, nullptr);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) workers.emplace_back(&ThreadPool::Work, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        jobs.push_back(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::Work() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace core
@@ -0,0 +1,270 @@
+// async.h
+#pragma once
+// сопрограммы C++20 для ядра: Task<T>, однопоточный Executor, ThreadPool для блокирующего
+// ввода-вывода и AsyncMutex. собирается отдельной целью bank_core_async (C++20),
+// остальное ядро остаётся на C++17 и подключается из /clr. в формы этот файл не подключать.
+//
+//   core::Executor exec;
+//   core::ThreadPool pool;
+//   exec.Spawn(Work(exec, pool));   // Work - сопрограмма, возвращающая Task<>
+//   exec.Run();                     // пока не завершатся все запущенные
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace core {
+
+template <class T = void>
+class Task;
+
+namespace detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    // задача ленивая: начинает выполняться, когда её ждут через co_await
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+            return h.promise().continuation;
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <class T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+    template <class U>
+    void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+    T Result() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+    void Result() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+} // namespace detail
+
+// результат сопрограммы; исключение внутри неё выбрасывается в ожидающем co_await
+template <class T>
+class Task {
+public:
+    using promise_type = detail::Promise<T>;
+
+private:
+    std::coroutine_handle<promise_type> h;
+
+public:
+    explicit Task(std::coroutine_handle<promise_type> h) noexcept : h(h) {}
+    Task(Task&& other) noexcept : h(std::exchange(other.h, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (h) h.destroy();
+            h = std::exchange(other.h, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (h) h.destroy();
+    }
+
+    bool await_ready() const noexcept { return !h || h.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        h.promise().continuation = caller;
+        return h;
+    }
+    T await_resume() { return h.promise().Result(); }
+};
+
+namespace detail {
+
+template <class T>
+Task<T> Promise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+// очередь готовых к продолжению сопрограмм, которую разбирает один поток в Run().
+// Post можно вызывать из любого потока (так пул возвращает сопрограммы после ввода-вывода)
+class Executor {
+private:
+    std::mutex m;
+    std::condition_variable wake;
+    std::deque<std::coroutine_handle<>> ready;
+    size_t running = 0; // запущенных через Spawn и ещё не завершённых
+    std::exception_ptr firstError;
+
+    struct Detached;
+    static Detached Start(Executor& exec, Task<void> task);
+    void Finished(std::exception_ptr error);
+
+public:
+    Executor() = default;
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    void Post(std::coroutine_handle<> h);
+
+    // co_await exec.Schedule() - уступить поток и продолжить после уже готовых сопрограмм
+    auto Schedule() {
+        struct Awaiter {
+            Executor& exec;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { exec.Post(h); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ *this };
+    }
+
+    // запускает задачу независимо от вызывающего; первое исключение таких задач бросит Run()
+    void Spawn(Task<void> task);
+    // выполняет сопрограммы, пока все запущенные через Spawn не завершатся
+    void Run();
+};
+
+// потоки для блокирующих вызовов (SQLite, файлы): co_await pool.Run(exec, fn) выполняет fn
+// на потоке пула, а сопрограмма продолжается снова на потоке exec.
+// io_uring тут не используется: SQLite сам делает свой ввод-вывод через VFS
+class ThreadPool {
+private:
+    std::mutex m;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    void Work();
+
+public:
+    explicit ThreadPool(size_t threads = 2);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> job);
+
+    template <class F>
+    auto Run(Executor& exec, F fn) {
+        using R = std::invoke_result_t<F&>;
+        using Stored = std::conditional_t<std::is_void_v<R>, std::monostate, std::optional<R>>;
+
+        struct Awaiter {
+            ThreadPool& pool;
+            Executor& exec;
+            F fn;
+            Stored result{};
+            std::exception_ptr error;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) {
+                pool.Submit([this, h] {
+                    try {
+                        if constexpr (std::is_void_v<R>) fn();
+                        else result.emplace(fn());
+                    }
+                    catch (...) {
+                        error = std::current_exception();
+                    }
+                    exec.Post(h);
+                });
+            }
+            R await_resume() {
+                if (error) std::rethrow_exception(error);
+                if constexpr (!std::is_void_v<R>) return std::move(*result);
+            }
+        };
+        return Awaiter{ *this, exec, std::move(fn), {}, {} };
+    }
+};
+
+// взаимное исключение для сопрограмм одного Executor (поток не блокируется, сопрограмма ждёт в очереди)
+//
+//   auto lock = co_await mutex.Lock();
+class AsyncMutex {
+private:
+    Executor& exec;
+    bool locked = false;
+    std::deque<std::coroutine_handle<>> waiters;
+
+public:
+    explicit AsyncMutex(Executor& exec) : exec(exec) {}
+    AsyncMutex(const AsyncMutex&) = delete;
+    AsyncMutex& operator=(const AsyncMutex&) = delete;
+
+    class Guard {
+    private:
+        AsyncMutex* mutex;
+
+    public:
+        explicit Guard(AsyncMutex* mutex) : mutex(mutex) {}
+        Guard(Guard&& other) noexcept : mutex(std::exchange(other.mutex, nullptr)) {}
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+        ~Guard() {
+            if (mutex) mutex->Unlock();
+        }
+    };
+
+    auto Lock() {
+        struct Awaiter {
+            AsyncMutex& mutex;
+            bool await_ready() {
+                if (mutex.locked) return false;
+                mutex.locked = true;
+                return true;
+            }
+            void await_suspend(std::coroutine_handle<> h) { mutex.waiters.push_back(h); }
+            Guard await_resume() { return Guard(&mutex); }
+        };
+        return Awaiter{ *this };
+    }
+
+    // следующий ожидающий получает блокировку сразу, не отпуская её
+    void Unlock() {
+        if (waiters.empty()) {
+            locked = false;
+            return;
+        }
+        std::coroutine_handle<> next = waiters.front();
+        waiters.pop_front();
+        exec.Post(next);
+    }
+};
+
+} // namespace core
@@ -0,0 +1,33 @@
+// async_storage.cpp
+#include "async_storage.h"
+#include "sqlite_storage.h"
+
+namespace core {
+
+// пулу отдаётся копия клиентов и изменений: пока идёт запись, банк на потоке Executor можно читать.
+// перенумерация и отметка о синхронизации - снова на потоке Executor. банк между копией и отметкой
+// не меняется: Modify ждёт guard
+Task<void> AsyncBankSystem::Save(std::string filename) {
+    auto lock = co_await guard.Lock();
+    std::vector<ClientRecord> clients = bank.GetClients();
+    ChangeSet changes = bank.GetChanges();
+    bool synced = bank.GetSyncedFile() == filename;
+    bool rewritten = co_await pool.Run(exec, [&] { return WriteDatabase(clients, changes, synced, filename); });
+    if (rewritten) bank.RenumberIds();
+    bank.MarkSynced(filename);
+}
+
+// база читается в отдельный BankSystem на потоке пула, а подменяется на потоке Executor,
+// так что подписчики (модель представления, индекс имён) получают OnReset на своём потоке
+Task<void> AsyncBankSystem::Load(std::string filename) {
+    auto lock = co_await guard.Lock();
+    std::vector<ClientRecord> loaded = co_await pool.Run(exec, [&filename] {
+        BankSystem temp;
+        LoadFromDatabase(temp, filename);
+        return temp.GetClients();
+    });
+    bank.Assign(std::move(loaded));
+    bank.MarkSynced(filename);
+}
+
+} // namespace core
@@ -0,0 +1,43 @@
+// async_storage.h
+#pragma once
+// BankSystem для сопрограмм (C++20, цель bank_core_async): сохранение и загрузка базы SQLite
+// идут на потоке ThreadPool, а поток Executor тем временем выполняет другие сопрограммы.
+// менять банк нужно через Modify: изменения ждут, пока идёт сохранение или загрузка.
+// читать банк на потоке Executor можно всегда: сохранение пишет копию клиентов
+//
+//   co_await system.Save("clients.db");
+//   co_await system.Modify([&](core::BankSystem& b) { b.AddClient(c); });
+#include "async.h"
+#include "bank_core.h"
+#include <string>
+#include <type_traits>
+
+namespace core {
+
+class AsyncBankSystem {
+private:
+    BankSystem& bank;
+    Executor& exec;
+    ThreadPool& pool;
+    AsyncMutex guard;
+
+public:
+    AsyncBankSystem(BankSystem& bank, Executor& exec, ThreadPool& pool)
+        : bank(bank), exec(exec), pool(pool), guard(exec) {
+    }
+
+    BankSystem& Native() { return bank; }
+
+    // как SaveToDatabase/LoadFromDatabase, ошибки SQLite - std::runtime_error из co_await
+    Task<void> Save(std::string filename);
+    Task<void> Load(std::string filename);
+
+    // fn(BankSystem&) на потоке Executor, когда банк не сохраняется и не загружается
+    template <class F>
+    Task<std::invoke_result_t<F&, BankSystem&>> Modify(F fn) {
+        auto lock = co_await guard.Lock();
+        co_return fn(bank);
+    }
+};
+
+} // namespace core
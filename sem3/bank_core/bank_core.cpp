@@ -0,0 +1,261 @@
+// bank_core.cpp
+#include "bank_core.h"
+#include "csv.h"
+#include <algorithm>
+
+namespace core {
+
+void BankSystem::AddObserver(BankObserver* o) {
+    observers.push_back(o);
+}
+
+void BankSystem::RemoveObserver(BankObserver* o) {
+    observers.erase(std::remove(observers.begin(), observers.end(), o), observers.end());
+}
+
+void BankSystem::NotifyReset() {
+    for (auto* o : observers) o->OnReset();
+}
+
+void BankSystem::NotifyReordered() {
+    for (auto* o : observers) o->OnReordered();
+}
+
+ClientHandle BankSystem::AllocateHandle(uint32_t position) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+    slots[slot].position = position;
+    return (static_cast<ClientHandle>(slots[slot].generation) << 32) | slot;
+}
+
+void BankSystem::ReleaseSlot(uint32_t slot) {
+    if (++slots[slot].generation == 0) slots[slot].generation = 1; // 0 не выдаём
+    freeSlots.push_back(slot);
+}
+
+void BankSystem::RebuildHandles() {
+    for (uint32_t slot : slotOf) ReleaseSlot(slot);
+    slotOf.clear();
+    slotOf.reserve(clients.size());
+    for (size_t i = 0; i < clients.size(); ++i) {
+        slotOf.push_back(static_cast<uint32_t>(AllocateHandle(static_cast<uint32_t>(i))));
+    }
+}
+
+void BankSystem::TrackRemoved(int64_t id) {
+    if (changes.added.erase(id) == 0) {
+        changes.updated.erase(id);
+        changes.removed.insert(id);
+    }
+}
+
+ClientHandle BankSystem::AddClient(const ClientRecord& c) {
+    clients.push_back(c);
+    clients.back().id = nextId++;
+    changes.added.insert(clients.back().id);
+    ClientHandle h = AllocateHandle(static_cast<uint32_t>(clients.size() - 1));
+    slotOf.push_back(static_cast<uint32_t>(h));
+    for (auto* o : observers) o->OnInserted(Count() - 1, h);
+    return h;
+}
+
+void BankSystem::RemoveClient(int index) {
+    if (index < 0 || index >= Count()) return;
+
+    TrackRemoved(clients[index].id);
+    ClientHandle h = GetHandle(index);
+    ReleaseSlot(slotOf[index]);
+    ClientRecord removed = std::move(clients[index]);
+    clients.erase(clients.begin() + index);
+    slotOf.erase(slotOf.begin() + index);
+    for (size_t i = static_cast<size_t>(index); i < slotOf.size(); ++i) {
+        slots[slotOf[i]].position = static_cast<uint32_t>(i);
+    }
+    for (auto* o : observers) o->OnRemoved(index, h, removed, -1);
+}
+
+ClientHandle BankSystem::GetHandle(int index) const {
+    if (index < 0 || index >= Count()) return 0;
+    uint32_t slot = slotOf[index];
+    return (static_cast<ClientHandle>(slots[slot].generation) << 32) | slot;
+}
+
+int BankSystem::IndexOf(ClientHandle h) const {
+    uint32_t slot = static_cast<uint32_t>(h);
+    uint32_t generation = static_cast<uint32_t>(h >> 32);
+    if (slot >= slots.size() || slots[slot].generation != generation) return -1;
+    uint32_t position = slots[slot].position;
+    // свободная ячейка тоже может совпасть по поколению (идентификатор не от этого банка)
+    if (position >= slotOf.size() || slotOf[position] != slot) return -1;
+    return static_cast<int>(position);
+}
+
+bool BankSystem::UpdateClientById(ClientHandle h, const ClientRecord& c) {
+    int index = IndexOf(h);
+    if (index < 0) return false;
+    UpdateClient(index, c);
+    return true;
+}
+
+bool BankSystem::RemoveClientById(ClientHandle h) {
+    int index = IndexOf(h);
+    if (index < 0) return false;
+
+    int last = Count() - 1;
+    ReleaseSlot(slotOf[index]);
+    ClientRecord removed = std::move(clients[index]);
+    if (index != last) {
+        // переставленный клиент забирает id удалённого, чтобы ORDER BY id совпадал с порядком в памяти:
+        // в базе его строка по старому id удаляется, а строка удалённого переписывается его данными
+        TrackRemoved(clients[last].id);
+        clients[index] = std::move(clients[last]);
+        clients[index].id = removed.id;
+        if (changes.added.count(removed.id) == 0)
+            changes.updated.insert(removed.id);
+        slotOf[index] = slotOf[last];
+        slots[slotOf[index]].position = static_cast<uint32_t>(index);
+    }
+    else {
+        TrackRemoved(removed.id);
+    }
+    clients.pop_back();
+    slotOf.pop_back();
+
+    int movedFrom = (index != last) ? last : -1;
+    for (auto* o : observers) o->OnRemoved(index, h, removed, movedFrom);
+    return true;
+}
+
+size_t BankSystem::RemoveClients(const std::vector<ClientHandle>& handles) {
+    std::vector<char> drop(clients.size(), 0);
+    size_t count = 0;
+    for (ClientHandle h : handles) {
+        int index = IndexOf(h);
+        if (index >= 0 && !drop[index]) {
+            drop[index] = 1;
+            ++count;
+        }
+    }
+    if (count == 0) return 0;
+
+    struct Removed {
+        int index;
+        ClientHandle handle;
+        ClientRecord record;
+    };
+    std::vector<Removed> removed;
+    removed.reserve(count);
+
+    size_t out = 0;
+    for (size_t i = 0; i < clients.size(); ++i) {
+        if (drop[i]) {
+            TrackRemoved(clients[i].id);
+            removed.push_back({ static_cast<int>(i), GetHandle(static_cast<int>(i)), std::move(clients[i]) });
+            ReleaseSlot(slotOf[i]);
+            continue;
+        }
+        if (out != i) {
+            clients[out] = std::move(clients[i]);
+            slotOf[out] = slotOf[i];
+        }
+        slots[slotOf[out]].position = static_cast<uint32_t>(out);
+        ++out;
+    }
+    clients.resize(out);
+    slotOf.resize(out);
+    // с конца: номер каждой удаляемой строки ещё верен, если применять события по порядку
+    for (auto it = removed.rbegin(); it != removed.rend(); ++it) {
+        for (auto* o : observers) o->OnRemoved(it->index, it->handle, it->record, -1);
+    }
+    return count;
+}
+
+void BankSystem::UpdateClient(int index, const ClientRecord& c) {
+    if (index < 0 || index >= Count()) return;
+
+    ClientRecord before = std::move(clients[index]);
+    clients[index] = c;
+    clients[index].id = before.id;
+    if (changes.added.count(before.id) == 0)
+        changes.updated.insert(before.id);
+    ClientHandle h = GetHandle(index);
+    for (auto* o : observers) o->OnUpdated(index, h, before);
+}
+
+void BankSystem::Clear() {
+    clients.clear();
+    RebuildHandles();
+    changes = ChangeSet();
+    NotifyReset();
+}
+
+void BankSystem::Assign(std::vector<ClientRecord> loaded) {
+    clients = std::move(loaded);
+    nextId = 1;
+    for (const auto& c : clients) {
+        if (c.id >= nextId) nextId = c.id + 1;
+    }
+    for (auto& c : clients) {
+        if (c.id == 0) c.id = nextId++;
+    }
+    RebuildHandles();
+    changes = ChangeSet();
+    syncedFile.clear();
+    NotifyReset();
+}
+
+void BankSystem::MarkSynced(const std::string& filename) {
+    changes = ChangeSet();
+    changes.reset = false;
+    syncedFile = filename;
+}
+
+void BankSystem::RenumberIds() {
+    for (size_t i = 0; i < clients.size(); ++i) {
+        clients[i].id = static_cast<int64_t>(i) + 1;
+    }
+    nextId = static_cast<int64_t>(clients.size()) + 1;
+    changes = ChangeSet();
+}
+
+double BankSystem::CalculateTotalIncome() const {
+    return Summarize().totalIncome;
+}
+
+// доход считается через целую сумму rate * amount, как в SummarizeDatabase,
+// поэтому итоги в памяти и по базе совпадают до последнего знака
+IncomeSummary BankSystem::Summarize() const {
+    IncomeSummary s;
+    int64_t vipSum = 0, simpleSum = 0;
+    for (const auto& c : clients) {
+        int64_t income = static_cast<int64_t>(c.rate) * c.EffectiveAmount();
+        if (c.vip) {
+            ++s.vipCount;
+            vipSum += income;
+        }
+        else {
+            simpleSum += income;
+        }
+    }
+    s.count = static_cast<int64_t>(clients.size());
+    s.vipIncome = vipSum / 100.0;
+    s.totalIncome = (vipSum + simpleSum) / 100.0;
+    return s;
+}
+
+void BankSystem::SaveToFile(const std::string& filename) const {
+    WriteCsvFile(clients, filename);
+}
+
+void BankSystem::LoadFromFile(const std::string& filename) {
+    Assign(ReadCsvFile(filename));
+}
+
+} // namespace core
@@ -0,0 +1,145 @@
+// bank_core.h
+#pragma once
+// переносимое ядро банковской системы (без .NET), формы laba4/laba5 - обёртка над ним.
+// заголовки ядра не подключают <thread>/<mutex>: они не компилируются под /clr
+#include "client_record.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace core {
+
+// изменения с последнего сохранения/загрузки базы, по id клиентов
+struct ChangeSet {
+    std::unordered_set<int64_t> added;
+    std::unordered_set<int64_t> updated; // только уже сохранённые клиенты
+    std::unordered_set<int64_t> removed; // только уже сохранённые клиенты
+    bool reset = true; // порядок или весь набор поменялся - таблицу нужно переписать
+
+    bool Empty() const { return !reset && added.empty() && updated.empty() && removed.empty(); }
+};
+
+// итоги по клиентам: всего и отдельно по VIP/обычным
+struct IncomeSummary {
+    int64_t count = 0;
+    int64_t vipCount = 0;
+    double totalIncome = 0.0;
+    double vipIncome = 0.0;
+
+    int64_t SimpleCount() const { return count - vipCount; }
+    double SimpleIncome() const { return totalIncome - vipIncome; }
+};
+
+// поля для сортировки; Amount - сумма с надбавкой VIP, как в таблице формы
+enum class SortField {
+    Type,
+    Name,
+    Rate,
+    Amount,
+    Income,
+};
+
+struct SortKey {
+    SortField field = SortField::Name;
+    bool descending = false;
+};
+
+// постоянный идентификатор клиента в памяти: не меняется при сортировке и удалении других.
+// старшие 32 бита - поколение ячейки, младшие - номер ячейки; 0 - нет клиента.
+// в отличие от ClientRecord::id (ключ строки в базе) при сохранении не перенумеровывается
+using ClientHandle = uint64_t;
+
+// подписчик на изменения списка клиентов, вызывается после изменения
+class BankObserver {
+public:
+    virtual ~BankObserver() = default;
+    virtual void OnInserted(int index, ClientHandle h) = 0;
+    virtual void OnUpdated(int index, ClientHandle h, const ClientRecord& before) = 0;
+    // movedFrom < 0: следующие строки сдвинулись на одну вверх;
+    // иначе на место index встал клиент с позиции movedFrom (последний), остальные на месте
+    virtual void OnRemoved(int index, ClientHandle h, const ClientRecord& removed, int movedFrom) = 0;
+    // весь набор поменялся (загрузка, очистка), прежние идентификаторы недействительны
+    virtual void OnReset() = 0;
+    // поменялся только порядок строк (сортировка): клиенты и их идентификаторы те же.
+    // подписчику, которому важны номера строк, хватает обработки как OnReset
+    virtual void OnReordered() { OnReset(); }
+};
+
+class BankSystem {
+private:
+    std::vector<ClientRecord> clients; // клиенты лежат подряд в памяти
+    int64_t nextId = 1;
+    ChangeSet changes;
+    std::string syncedFile; // база, с которой совпадает состояние без учёта changes
+    std::vector<BankObserver*> observers;
+
+    // slot map: ячейка помнит позицию клиента в clients, slotOf - обратная связь.
+    // освобождённая ячейка получает новое поколение, старые идентификаторы становятся недействительны
+    struct Slot {
+        uint32_t generation = 1;
+        uint32_t position = 0;
+    };
+    std::vector<Slot> slots;
+    std::vector<uint32_t> slotOf; // позиция -> ячейка
+    std::vector<uint32_t> freeSlots;
+
+    void NotifyReset();
+    void NotifyReordered();
+    ClientHandle AllocateHandle(uint32_t position);
+    void ReleaseSlot(uint32_t slot);
+    void RebuildHandles(); // после замены всех клиентов
+    void TrackRemoved(int64_t id);
+
+public:
+    // подписчик не принадлежит BankSystem и должен отписаться сам
+    void AddObserver(BankObserver* o);
+    void RemoveObserver(BankObserver* o);
+
+    // id в переданной записи игнорируется: новый выдаётся здесь, при обновлении сохраняется старый
+    ClientHandle AddClient(const ClientRecord& c);
+    void Clear();
+
+    // доступ по номеру строки (для таблицы); удаление сдвигает следующих клиентов, O(n)
+    void RemoveClient(int index);
+    void UpdateClient(int index, const ClientRecord& c);
+
+    // доступ по идентификатору, O(1)
+    ClientHandle GetHandle(int index) const;
+    int IndexOf(ClientHandle h) const; // -1, если клиента уже нет
+    bool UpdateClientById(ClientHandle h, const ClientRecord& c);
+    // на место удалённого встаёт последний клиент (и получает его id), остальные не сдвигаются
+    bool RemoveClientById(ClientHandle h);
+    // удаление многих клиентов за один проход с сохранением порядка, O(n); возвращает число удалённых.
+    // подписчики получают OnRemoved на каждого клиента от последней строки к первой (movedFrom = -1)
+    size_t RemoveClients(const std::vector<ClientHandle>& handles);
+
+    // заменить всех клиентов загруженными; записи с id == 0 получают новые id
+    void Assign(std::vector<ClientRecord> loaded);
+
+    const ChangeSet& GetChanges() const { return changes; }
+    const std::string& GetSyncedFile() const { return syncedFile; }
+    // состояние записано в базу filename (или прочитано из неё)
+    void MarkSynced(const std::string& filename);
+    // id = позиция + 1, чтобы порядок строк в базе (ORDER BY id) совпал с текущим
+    void RenumberIds();
+
+    int Count() const { return static_cast<int>(clients.size()); }
+    const ClientRecord& GetClient(int index) const { return clients[index]; }
+    const std::vector<ClientRecord>& GetClients() const { return clients; }
+
+    double CalculateTotalIncome() const;
+    IncomeSummary Summarize() const;
+
+    // устойчивая сортировка по нескольким ключам (первый главный), O(n log n).
+    // имена сравниваются без учёта регистра; большие таблицы сортируются в нескольких потоках
+    void Sort(const std::vector<SortKey>& keys);
+    void SortByName() { Sort({ { SortField::Name, false } }); }
+
+    // CSV как в laba4: тип,имя,ставка,сумма (без надбавки VIP), см. csv.h.
+    // при ошибке бросает std::runtime_error (CsvError с номером строки для плохих данных),
+    // при ошибке загрузки клиенты не меняются
+    void SaveToFile(const std::string& filename) const;
+    void LoadFromFile(const std::string& filename);
+};
+
+} // namespace core
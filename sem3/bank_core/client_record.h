@@ -0,0 +1,40 @@
+// client_record.h
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace core {
+
+// клиент как обычное значение: без наследования и без виртуальных вызовов.
+// amount хранится "чистым", надбавка VIP (+1000) добавляется при расчёте
+struct ClientRecord {
+    int64_t id = 0;   // ключ строки в базе, выдаёт BankSystem (0 - ещё не выдан)
+    std::string name; // UTF-8
+    int rate = 0;     // ставка в процентах
+    int amount = 0;   // введённая сумма вклада
+    bool vip = false;
+
+    static constexpr int VipBonus = 1000;
+
+    // сумма вклада с учётом надбавки, как Client::Amount в формах
+    int EffectiveAmount() const {
+        return vip ? amount + VipBonus : amount;
+    }
+
+    // то же, что SimpleClient::Calculate / VIPClient::Calculate
+    double Calculate() const {
+        return static_cast<double>(rate) * EffectiveAmount() / 100.0;
+    }
+
+    // доход в сотых долях (копейках), без ошибок округления
+    int64_t IncomeCents() const {
+        return static_cast<int64_t>(rate) * EffectiveAmount();
+    }
+};
+
+// сравниваются только данные клиента, без id
+inline bool operator==(const ClientRecord& a, const ClientRecord& b) {
+    return a.vip == b.vip && a.rate == b.rate && a.amount == b.amount && a.name == b.name;
+}
+
+} // namespace core
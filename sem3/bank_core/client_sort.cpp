@@ -0,0 +1,136 @@
+// client_sort.cpp
+#include "bank_core.h"
+#include "text.h"
+#include <algorithm>
+#include <thread>
+
+namespace core {
+
+namespace {
+
+// ключи сортировки считаются один раз на клиента, а не в каждом сравнении
+struct SortColumns {
+    std::vector<std::string> names;
+    std::vector<int64_t> numbers[4]; // Type, Rate, Amount, Income
+
+    static int Slot(SortField f) {
+        switch (f) {
+        case SortField::Type:   return 0;
+        case SortField::Rate:   return 1;
+        case SortField::Amount: return 2;
+        case SortField::Income: return 3;
+        default: return -1;
+        }
+    }
+};
+
+class Comparator {
+private:
+    const SortColumns& cols;
+    const std::vector<SortKey>& keys;
+
+public:
+    Comparator(const SortColumns& c, const std::vector<SortKey>& k) : cols(c), keys(k) {}
+
+    bool operator()(uint32_t a, uint32_t b) const {
+        for (const auto& key : keys) {
+            int cmp;
+            if (key.field == SortField::Name) {
+                cmp = cols.names[a].compare(cols.names[b]);
+            }
+            else {
+                const auto& v = cols.numbers[SortColumns::Slot(key.field)];
+                cmp = (v[a] > v[b]) - (v[a] < v[b]);
+            }
+            if (cmp != 0) return key.descending ? cmp > 0 : cmp < 0;
+        }
+        return false;
+    }
+};
+
+// сортировка слиянием: куски сортируются в потоках, затем сливаются попарно.
+// std::stable_sort и std::inplace_merge сохраняют порядок равных, поэтому результат устойчив
+void ParallelStableSort(std::vector<uint32_t>& order, const Comparator& less) {
+    const size_t minPart = 1 << 16;
+    size_t parts = std::max<size_t>(1, std::thread::hardware_concurrency());
+    parts = std::min(parts, std::max<size_t>(1, order.size() / minPart));
+    if (parts == 1) {
+        std::stable_sort(order.begin(), order.end(), less);
+        return;
+    }
+
+    std::vector<size_t> bounds(parts + 1);
+    for (size_t i = 0; i <= parts; ++i) bounds[i] = order.size() * i / parts;
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < parts; ++i) {
+        workers.emplace_back([&, i] {
+            std::stable_sort(order.begin() + bounds[i], order.begin() + bounds[i + 1], less);
+        });
+    }
+    for (auto& t : workers) t.join();
+
+    for (size_t width = 1; width < parts; width *= 2) {
+        workers.clear();
+        for (size_t i = 0; i + width < parts; i += 2 * width) {
+            size_t lo = bounds[i], mid = bounds[i + width], hi = bounds[std::min(i + 2 * width, parts)];
+            workers.emplace_back([&, lo, mid, hi] {
+                std::inplace_merge(order.begin() + lo, order.begin() + mid, order.begin() + hi, less);
+            });
+        }
+        for (auto& t : workers) t.join();
+    }
+}
+
+} // namespace
+
+void BankSystem::Sort(const std::vector<SortKey>& keys) {
+    if (clients.size() < 2 || keys.empty()) return;
+
+    SortColumns cols;
+    bool needName = false;
+    bool needNumber[4] = {};
+    for (const auto& k : keys) {
+        if (k.field == SortField::Name) needName = true;
+        else needNumber[SortColumns::Slot(k.field)] = true;
+    }
+
+    const size_t n = clients.size();
+    if (needName) {
+        cols.names.reserve(n);
+        for (const auto& c : clients) cols.names.push_back(CollationKey(c.name));
+    }
+    for (int s = 0; s < 4; ++s) {
+        if (!needNumber[s]) continue;
+        auto& v = cols.numbers[s];
+        v.reserve(n);
+        for (const auto& c : clients) {
+            switch (s) {
+            case 0: v.push_back(c.vip ? 1 : 0); break;
+            case 1: v.push_back(c.rate); break;
+            case 2: v.push_back(c.EffectiveAmount()); break;
+            default: v.push_back(static_cast<int64_t>(c.rate) * c.EffectiveAmount()); break;
+            }
+        }
+    }
+
+    std::vector<uint32_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint32_t>(i);
+    ParallelStableSort(order, Comparator(cols, keys));
+
+    std::vector<ClientRecord> sorted;
+    std::vector<uint32_t> sortedSlots;
+    sorted.reserve(n);
+    sortedSlots.reserve(n);
+    for (uint32_t i : order) {
+        slots[slotOf[i]].position = static_cast<uint32_t>(sorted.size());
+        sorted.push_back(std::move(clients[i]));
+        sortedSlots.push_back(slotOf[i]);
+    }
+    clients = std::move(sorted);
+    slotOf = std::move(sortedSlots);
+    changes.reset = true;
+    NotifyReordered();
+}
+
+} // namespace core
@@ -0,0 +1,380 @@
+// columnar.cpp
+#include "columnar.h"
+#include "csv.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace core {
+
+static const char magic[8] = { 'B', 'A', 'N', 'K', 'C', 'O', 'L', '1' };
+
+enum ColumnId : uint32_t {
+    IdColumn = 1,
+    TypeColumn = 2,
+    RateColumn = 3,
+    AmountColumn = 4,
+    NameColumn = 5,
+};
+
+[[noreturn]] static void Corrupted() {
+    throw std::runtime_error("файл .bcol повреждён");
+}
+
+// ---------- запись ----------
+
+template <typename T>
+static void Put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void AlignTo8(std::string& out) {
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+static int BitWidth(uint64_t v) {
+    int w = 0;
+    while (v) {
+        ++w;
+        v >>= 1;
+    }
+    return w;
+}
+
+// минимум + (значение - минимум) в width битах, слова по 64 бита.
+// формат: int64 минимум, uint64 ширина, слова
+static void PackInts(const std::vector<int64_t>& values, std::string& out) {
+    int64_t base = 0;
+    uint64_t range = 0;
+    if (!values.empty()) {
+        base = values[0];
+        int64_t top = values[0];
+        for (int64_t v : values) {
+            if (v < base) base = v;
+            if (v > top) top = v;
+        }
+        range = static_cast<uint64_t>(top) - static_cast<uint64_t>(base);
+    }
+    uint64_t width = static_cast<uint64_t>(BitWidth(range));
+    Put(out, base);
+    Put(out, width);
+    if (width == 0) return;
+
+    std::vector<uint64_t> words((values.size() * width + 63) / 64, 0);
+    uint64_t bit = 0;
+    for (int64_t v : values) {
+        uint64_t x = static_cast<uint64_t>(v) - static_cast<uint64_t>(base);
+        size_t word = static_cast<size_t>(bit / 64);
+        unsigned shift = static_cast<unsigned>(bit % 64);
+        words[word] |= x << shift;
+        if (shift + width > 64) words[word + 1] |= x >> (64 - shift);
+        bit += width;
+    }
+    out.append(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+}
+
+static uint64_t ZigZag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static int64_t UnZigZag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+void SaveToColumnar(const BankSystem& bank, const std::string& filename) {
+    const auto& clients = bank.GetClients();
+    std::vector<std::pair<uint32_t, std::string>> columns;
+
+    {
+        std::vector<int64_t> deltas;
+        deltas.reserve(clients.size());
+        int64_t prev = 0;
+        for (const auto& c : clients) {
+            deltas.push_back(static_cast<int64_t>(ZigZag(c.id - prev)));
+            prev = c.id;
+        }
+        std::string data;
+        PackInts(deltas, data);
+        columns.emplace_back(IdColumn, std::move(data));
+    }
+    {
+        std::string data((clients.size() + 7) / 8, '\0');
+        for (size_t i = 0; i < clients.size(); ++i) {
+            if (clients[i].vip) data[i / 8] = static_cast<char>(data[i / 8] | (1 << (i % 8)));
+        }
+        columns.emplace_back(TypeColumn, std::move(data));
+    }
+    {
+        std::vector<int64_t> rates, amounts;
+        rates.reserve(clients.size());
+        amounts.reserve(clients.size());
+        for (const auto& c : clients) {
+            rates.push_back(c.rate);
+            amounts.push_back(c.amount);
+        }
+        std::string data;
+        PackInts(rates, data);
+        columns.emplace_back(RateColumn, std::move(data));
+        data.clear();
+        PackInts(amounts, data);
+        columns.emplace_back(AmountColumn, std::move(data));
+    }
+    {
+        // словарь: uint64 число имён, упакованные длины, байты имён (выровнены), упакованные номера
+        std::unordered_map<std::string_view, int64_t> dict;
+        std::vector<int64_t> codes, lengths;
+        std::string bytes;
+        codes.reserve(clients.size());
+        for (const auto& c : clients) {
+            auto it = dict.emplace(c.name, static_cast<int64_t>(dict.size())).first;
+            if (it->second == static_cast<int64_t>(lengths.size())) {
+                lengths.push_back(static_cast<int64_t>(c.name.size()));
+                bytes += c.name;
+            }
+            codes.push_back(it->second);
+        }
+        std::string data;
+        Put(data, static_cast<uint64_t>(lengths.size()));
+        PackInts(lengths, data);
+        Put(data, static_cast<uint64_t>(bytes.size()));
+        data += bytes;
+        AlignTo8(data);
+        PackInts(codes, data);
+        columns.emplace_back(NameColumn, std::move(data));
+    }
+
+    // заголовок: magic, uint64 строк, uint64 столбцов, каталог (id, смещение, размер), столбцы
+    std::string header(magic, sizeof(magic));
+    Put(header, static_cast<uint64_t>(clients.size()));
+    Put(header, static_cast<uint64_t>(columns.size()));
+    uint64_t offset = header.size() + columns.size() * 3 * sizeof(uint64_t);
+    for (const auto& col : columns) {
+        Put(header, static_cast<uint64_t>(col.first));
+        Put(header, offset);
+        Put(header, static_cast<uint64_t>(col.second.size()));
+        offset += (col.second.size() + 7) / 8 * 8;
+    }
+
+    std::ofstream out(std::filesystem::u8path(filename), std::ios::binary);
+    if (!out) throw std::runtime_error("не удалось открыть файл: " + filename);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    for (auto& col : columns) {
+        AlignTo8(col.second);
+        out.write(col.second.data(), static_cast<std::streamsize>(col.second.size()));
+    }
+    if (!out) throw std::runtime_error("ошибка записи в файл: " + filename);
+}
+
+// ---------- чтение ----------
+
+// чтение с проверкой границ, данные файла не копируются
+class Cursor {
+private:
+    std::string_view data;
+    size_t pos = 0;
+
+public:
+    explicit Cursor(std::string_view d) : data(d) {}
+
+    template <typename T>
+    T Get() {
+        if (data.size() - pos < sizeof(T)) Corrupted();
+        T value;
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    std::string_view Bytes(size_t n) {
+        if (data.size() - pos < n) Corrupted();
+        std::string_view s = data.substr(pos, n);
+        pos += n;
+        return s;
+    }
+
+    void AlignTo8() {
+        pos = (pos + 7) / 8 * 8;
+        if (pos > data.size()) pos = data.size();
+    }
+
+    size_t Remaining() const { return data.size() - pos; }
+};
+
+// count приходит из файла: при width > 0 его биты должны быть в файле до выделения памяти.
+// при width = 0 байтов нет вовсе, count ограничен проверкой rows в ColumnarReader
+static std::vector<int64_t> UnpackInts(Cursor& in, uint64_t count) {
+    int64_t base = in.Get<int64_t>();
+    uint64_t width = in.Get<uint64_t>();
+    if (width > 64) Corrupted();
+
+    std::string_view raw;
+    if (width != 0 && count != 0) {
+        if (count > in.Remaining() * 8 / width) Corrupted();
+        raw = in.Bytes(static_cast<size_t>((count * width + 63) / 64) * sizeof(uint64_t));
+    }
+    std::vector<int64_t> values(static_cast<size_t>(count), base);
+    if (raw.empty()) return values;
+
+    const uint64_t mask = width == 64 ? ~0ULL : ((1ULL << width) - 1);
+
+    uint64_t bit = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        size_t word = static_cast<size_t>(bit / 64);
+        unsigned shift = static_cast<unsigned>(bit % 64);
+        uint64_t lo, hi = 0;
+        std::memcpy(&lo, raw.data() + word * 8, 8);
+        uint64_t x = lo >> shift;
+        if (shift + width > 64) {
+            std::memcpy(&hi, raw.data() + (word + 1) * 8, 8);
+            x |= hi << (64 - shift);
+        }
+        values[i] = static_cast<int64_t>(static_cast<uint64_t>(base) + (x & mask));
+        bit += width;
+    }
+    return values;
+}
+
+ColumnarReader::ColumnarReader(const std::string& filename)
+    : file(filename) {
+    Cursor in(file.View());
+    if (in.Bytes(sizeof(magic)) != std::string_view(magic, sizeof(magic)))
+        throw std::runtime_error("не файл .bcol: " + filename);
+    rows = in.Get<uint64_t>();
+    uint64_t count = in.Get<uint64_t>();
+    if (count > in.Remaining() / (3 * sizeof(uint64_t))) Corrupted();
+    columns.reserve(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count; ++i) {
+        Column c;
+        c.id = static_cast<uint32_t>(in.Get<uint64_t>());
+        c.offset = in.Get<uint64_t>();
+        c.size = in.Get<uint64_t>();
+        if (c.offset > file.View().size() || c.size > file.View().size() - c.offset) Corrupted();
+        columns.push_back(c);
+    }
+    // в столбце типа на каждую строку есть бит: так rows из заголовка не больше, чем данных в файле
+    uint64_t typeBytes = rows / 8 + (rows % 8 != 0);
+    if (ColumnData(TypeColumn).size() < typeBytes) Corrupted();
+}
+
+std::string_view ColumnarReader::ColumnData(uint32_t id) const {
+    for (const auto& c : columns) {
+        if (c.id == id) return file.View().substr(static_cast<size_t>(c.offset), static_cast<size_t>(c.size));
+    }
+    Corrupted();
+}
+
+std::vector<int64_t> ColumnarReader::ReadIds() const {
+    Cursor in(ColumnData(IdColumn));
+    std::vector<int64_t> ids = UnpackInts(in, rows);
+    int64_t prev = 0;
+    for (auto& v : ids) {
+        prev += UnZigZag(static_cast<uint64_t>(v));
+        v = prev;
+    }
+    return ids;
+}
+
+std::vector<uint8_t> ColumnarReader::ReadVipFlags() const {
+    std::string_view bits = ColumnData(TypeColumn);
+    if (bits.size() < (rows + 7) / 8) Corrupted();
+    std::vector<uint8_t> flags(static_cast<size_t>(rows));
+    for (size_t i = 0; i < flags.size(); ++i) {
+        flags[i] = (static_cast<unsigned char>(bits[i / 8]) >> (i % 8)) & 1;
+    }
+    return flags;
+}
+
+static std::vector<int32_t> ToInt32(const std::vector<int64_t>& v) {
+    return std::vector<int32_t>(v.begin(), v.end());
+}
+
+std::vector<int32_t> ColumnarReader::ReadRates() const {
+    Cursor in(ColumnData(RateColumn));
+    return ToInt32(UnpackInts(in, rows));
+}
+
+std::vector<int32_t> ColumnarReader::ReadAmounts() const {
+    Cursor in(ColumnData(AmountColumn));
+    return ToInt32(UnpackInts(in, rows));
+}
+
+std::vector<std::string> ColumnarReader::ReadNames() const {
+    Cursor in(ColumnData(NameColumn));
+    uint64_t dictSize = in.Get<uint64_t>();
+    if (dictSize > rows) Corrupted(); // в словаре только имена, которые встречаются в строках
+    std::vector<int64_t> lengths = UnpackInts(in, dictSize);
+    std::string_view bytes = in.Bytes(static_cast<size_t>(in.Get<uint64_t>()));
+    in.AlignTo8();
+    std::vector<int64_t> codes = UnpackInts(in, rows);
+
+    std::vector<std::string_view> dict;
+    dict.reserve(lengths.size());
+    size_t pos = 0;
+    for (int64_t len : lengths) {
+        if (len < 0 || static_cast<uint64_t>(len) > bytes.size() - pos) Corrupted();
+        dict.push_back(bytes.substr(pos, static_cast<size_t>(len)));
+        pos += static_cast<size_t>(len);
+    }
+
+    std::vector<std::string> names;
+    names.reserve(codes.size());
+    for (int64_t code : codes) {
+        if (code < 0 || static_cast<uint64_t>(code) >= dict.size()) Corrupted();
+        names.emplace_back(dict[static_cast<size_t>(code)]);
+    }
+    return names;
+}
+
+IncomeSummary ColumnarReader::Summarize() const {
+    std::vector<uint8_t> vip = ReadVipFlags();
+    std::vector<int32_t> rates = ReadRates();
+    std::vector<int32_t> amounts = ReadAmounts();
+
+    IncomeSummary s;
+    int64_t vipSum = 0, simpleSum = 0;
+    for (size_t i = 0; i < vip.size(); ++i) {
+        int64_t amount = amounts[i] + (vip[i] ? ClientRecord::VipBonus : 0);
+        int64_t income = static_cast<int64_t>(rates[i]) * amount;
+        if (vip[i]) {
+            ++s.vipCount;
+            vipSum += income;
+        }
+        else {
+            simpleSum += income;
+        }
+    }
+    s.count = static_cast<int64_t>(rows);
+    s.vipIncome = vipSum / 100.0;
+    s.totalIncome = (vipSum + simpleSum) / 100.0;
+    return s;
+}
+
+void LoadFromColumnar(BankSystem& bank, const std::string& filename) {
+    ColumnarReader reader(filename);
+    std::vector<int64_t> ids = reader.ReadIds();
+    std::vector<uint8_t> vip = reader.ReadVipFlags();
+    std::vector<int32_t> rates = reader.ReadRates();
+    std::vector<int32_t> amounts = reader.ReadAmounts();
+    std::vector<std::string> names = reader.ReadNames();
+
+    std::vector<ClientRecord> loaded(ids.size());
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        loaded[i].id = ids[i];
+        loaded[i].vip = vip[i] != 0;
+        loaded[i].rate = rates[i];
+        loaded[i].amount = amounts[i];
+        loaded[i].name = std::move(names[i]);
+    }
+    bank.Assign(std::move(loaded));
+}
+
+void ConvertCsvToColumnar(const std::string& csvFile, const std::string& columnarFile) {
+    BankSystem bank;
+    bank.LoadFromFile(csvFile);
+    SaveToColumnar(bank, columnarFile);
+}
+
+} // namespace core
@@ -0,0 +1,56 @@
+// columnar.h
+#pragma once
+// колоночный формат таблицы клиентов (.bcol): каждый столбец хранится и сжимается отдельно,
+// поэтому для расчёта по ставкам и суммам имена вообще не читаются.
+//   id      - разности соседних id, зигзаг, упаковка битов
+//   тип     - битовая маска VIP
+//   ставка  - минимум + упаковка битов
+//   сумма   - минимум + упаковка битов (без надбавки VIP)
+//   имя     - словарь уникальных имён + упакованные номера в словаре
+// числа пишутся в порядке байт little-endian (x86, ARM)
+#include "bank_core.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core {
+
+class ColumnarReader {
+private:
+    struct Column {
+        uint32_t id = 0;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    MappedFile file;
+    uint64_t rows = 0;
+    std::vector<Column> columns;
+
+    std::string_view ColumnData(uint32_t id) const;
+
+public:
+    // файл отображается в память, столбцы разбираются только по запросу.
+    // бросает std::runtime_error, если это не файл .bcol или он повреждён
+    explicit ColumnarReader(const std::string& filename);
+
+    uint64_t RowCount() const { return rows; }
+
+    std::vector<int64_t> ReadIds() const;
+    std::vector<uint8_t> ReadVipFlags() const;
+    std::vector<int32_t> ReadRates() const;
+    std::vector<int32_t> ReadAmounts() const;
+    std::vector<std::string> ReadNames() const;
+
+    // итоги по доходу только по столбцам тип/ставка/сумма
+    IncomeSummary Summarize() const;
+};
+
+void SaveToColumnar(const BankSystem& bank, const std::string& filename);
+void LoadFromColumnar(BankSystem& bank, const std::string& filename);
+
+// перевод из CSV laba4 в .bcol
+void ConvertCsvToColumnar(const std::string& csvFile, const std::string& columnarFile);
+
+} // namespace core
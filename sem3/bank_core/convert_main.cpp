@@ -0,0 +1,42 @@
+// convert_main.cpp
+// bank_convert <вход .csv|.db> <выход .bcol> - перевод таблицы клиентов в колоночный формат
+#include "columnar.h"
+#ifdef BANK_CORE_WITH_SQLITE
+#include "sqlite_storage.h"
+#endif
+#include <iostream>
+#include <string>
+
+static bool EndsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "использование: bank_convert <вход .csv|.db> <выход .bcol>\n";
+        return 2;
+    }
+    std::string in = argv[1], out = argv[2];
+
+    try {
+        if (EndsWith(in, ".csv")) {
+            core::ConvertCsvToColumnar(in, out);
+        }
+#ifdef BANK_CORE_WITH_SQLITE
+        else if (EndsWith(in, ".db")) {
+            core::ConvertDatabaseToColumnar(in, out);
+        }
+#endif
+        else {
+            std::cerr << "неизвестный формат входного файла: " << in << "\n";
+            return 2;
+        }
+        core::ColumnarReader reader(out);
+        std::cout << "записано клиентов: " << reader.RowCount() << "\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "ошибка: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
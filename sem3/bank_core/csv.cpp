@@ -0,0 +1,293 @@
+// csv.cpp
+#include "csv.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSV_USE_SSE2 1
+#endif
+
+namespace core {
+
+static const char utf8Bom[] = "\xEF\xBB\xBF";
+
+// ---------- запись ----------
+
+static bool NeedsQuotes(std::string_view s) {
+    return s.find_first_of(",\"\r\n") != std::string_view::npos;
+}
+
+void AppendCsvRow(std::string& out, const ClientRecord& c) {
+    out += c.vip ? "VIP," : "Simple,";
+    if (NeedsQuotes(c.name)) {
+        out += '"';
+        for (char ch : c.name) {
+            if (ch == '"') out += '"';
+            out += ch;
+        }
+        out += '"';
+    }
+    else {
+        out += c.name;
+    }
+
+    char num[16];
+    out += ',';
+    out.append(num, std::to_chars(num, num + sizeof(num), c.rate).ptr);
+    out += ',';
+    out.append(num, std::to_chars(num, num + sizeof(num), c.amount).ptr);
+    out += "\r\n";
+}
+
+void WriteCsvFile(const std::vector<ClientRecord>& clients, const std::string& filename) {
+    std::ofstream out(std::filesystem::u8path(filename), std::ios::binary);
+    if (!out) throw std::runtime_error("не удалось открыть файл: " + filename);
+
+    // BOM, как у StreamWriter с Encoding::UTF8: Excel тогда читает кириллицу
+    std::string buffer(utf8Bom);
+    const size_t flushSize = 1 << 20;
+    buffer.reserve(flushSize + 256);
+    for (const auto& c : clients) {
+        AppendCsvRow(buffer, c);
+        if (buffer.size() >= flushSize) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!out) throw std::runtime_error("ошибка записи в файл: " + filename);
+}
+
+// ---------- чтение ----------
+
+// первый из символов , " \r \n начиная с p (или end). по 16 байт за шаг, если есть SSE2
+static const char* FindSpecial(const char* p, const char* end) {
+#ifdef CSV_USE_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quote)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            int bit = 0;
+            while (!(mask & (1 << bit))) ++bit;
+            return p + bit;
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c == ',' || c == '"' || c == '\r' || c == '\n') return p;
+    }
+    return end;
+}
+
+static const char* FindChar(const char* p, const char* end, char c) {
+    const void* hit = std::memchr(p, c, static_cast<size_t>(end - p));
+    return hit ? static_cast<const char*>(hit) : end;
+}
+
+static bool ParseIntField(std::string_view s, int& value) {
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    return ec == std::errc() && ptr == s.data() + s.size() && !s.empty();
+}
+
+namespace {
+
+struct ChunkResult {
+    std::vector<ClientRecord> rows;
+    int64_t lines = 0;      // переводов строк в куске
+    int64_t errorLine = 0;  // номер строки внутри куска (с 1), 0 - ошибок нет
+    std::string error;
+};
+
+class ChunkParser {
+private:
+    const char* p;
+    const char* end;
+    ChunkResult& res;
+    int64_t line = 1;
+    std::string fields[4];
+    std::string extra;
+
+    bool Fail(const char* what) {
+        res.errorLine = line;
+        res.error = what;
+        return false;
+    }
+
+    // поле в кавычках; p стоит на открывающей кавычке
+    bool QuotedField(std::string& out) {
+        ++p;
+        while (true) {
+            const char* q = FindChar(p, end, '"');
+            if (q == end) return Fail("нет закрывающей кавычки");
+            for (const char* s = p; s < q; ++s) {
+                if (*s == '\n') ++line;
+            }
+            out.append(p, q);
+            p = q + 1;
+            if (p < end && *p == '"') { // "" внутри поля
+                out += '"';
+                ++p;
+                continue;
+            }
+            if (p < end && *p != ',' && *p != '\r' && *p != '\n')
+                return Fail("лишние символы после закрывающей кавычки");
+            return true;
+        }
+    }
+
+    bool UnquotedField(std::string& out) {
+        const char* s = FindSpecial(p, end);
+        if (s < end && *s == '"') return Fail("кавычка внутри поля без кавычек");
+        out.assign(p, s);
+        p = s;
+        return true;
+    }
+
+    // одна запись до конца строки включительно
+    bool Record() {
+        int count = 0;
+        while (true) {
+            std::string& out = count < 4 ? fields[count] : extra;
+            out.clear();
+            if (p < end && *p == '"' ? !QuotedField(out) : !UnquotedField(out)) return false;
+            ++count;
+
+            if (p < end && *p == ',') {
+                ++p;
+                continue;
+            }
+            if (p < end && *p == '\r') {
+                ++p;
+                if (p == end || *p != '\n') return Fail("символ CR без LF");
+            }
+            break; // p на '\n' или в конце
+        }
+        if (count != 4) return Fail("ожидалось 4 поля");
+
+        ClientRecord c;
+        if (fields[0] == "VIP") c.vip = true;
+        else if (fields[0] != "Simple") return Fail("тип клиента должен быть VIP или Simple");
+        c.name = std::move(fields[1]);
+        if (!ParseIntField(fields[2], c.rate)) return Fail("ставка должна быть целым числом");
+        if (!ParseIntField(fields[3], c.amount)) return Fail("сумма должна быть целым числом");
+        res.rows.push_back(std::move(c));
+        return true;
+    }
+
+public:
+    ChunkParser(std::string_view chunk, ChunkResult& result)
+        : p(chunk.data()), end(chunk.data() + chunk.size()), res(result) {
+    }
+
+    void Run() {
+        while (p < end) {
+            if (*p == '\n' || (*p == '\r' && p + 1 < end && p[1] == '\n')) {
+                p += (*p == '\r') ? 2 : 1; // пустая строка
+            }
+            else if (!Record()) {
+                return;
+            }
+            else if (p < end) {
+                ++p; // '\n'
+            }
+            ++line;
+        }
+        res.lines = line - 1;
+    }
+};
+
+} // namespace
+
+// конец записи не раньше target: первый '\n' вне кавычек.
+// inQuotes - состояние на позиции from, обновляется до возвращаемой позиции
+static size_t NextRecordBoundary(std::string_view data, size_t from, size_t target, bool& inQuotes) {
+    const char* base = data.data();
+    const char* end = base + data.size();
+    const char* p = base + from;
+
+    // до target только считаем кавычки
+    const char* t = base + target;
+    for (const char* q = FindChar(p, t, '"'); q < t; q = FindChar(q + 1, t, '"')) {
+        inQuotes = !inQuotes;
+    }
+    p = t;
+
+    while (p < end) {
+        const char* nl = FindChar(p, end, '\n');
+        const char* q = FindChar(p, nl, '"');
+        if (q < nl) {
+            inQuotes = !inQuotes;
+            p = q + 1;
+            continue;
+        }
+        if (!inQuotes) return static_cast<size_t>(nl - base) + (nl < end ? 1 : 0);
+        p = nl + 1;
+    }
+    return data.size();
+}
+
+std::vector<ClientRecord> ParseCsv(std::string_view data) {
+    if (data.compare(0, 3, utf8Bom) == 0) data.remove_prefix(3);
+
+    const size_t minChunk = 4 << 20; // мелкие файлы в один поток
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<size_t>(1, data.size() / minChunk));
+
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    bool inQuotes = false;
+    for (size_t i = 1; i <= threads && begin < data.size(); ++i) {
+        size_t end = data.size();
+        if (i < threads) {
+            size_t target = std::max(begin, data.size() * i / threads);
+            end = NextRecordBoundary(data, begin, target, inQuotes);
+        }
+        chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<ChunkResult> parts(chunks.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back([&, i] { ChunkParser(chunks[i], parts[i]).Run(); });
+    }
+    if (!chunks.empty()) ChunkParser(chunks[0], parts[0]).Run();
+    for (auto& t : workers) t.join();
+
+    size_t total = 0;
+    int64_t lineOffset = 0;
+    for (const auto& part : parts) {
+        if (part.errorLine != 0) throw CsvError(lineOffset + part.errorLine, part.error);
+        lineOffset += part.lines;
+        total += part.rows.size();
+    }
+
+    std::vector<ClientRecord> rows;
+    rows.reserve(total);
+    for (auto& part : parts) {
+        std::move(part.rows.begin(), part.rows.end(), std::back_inserter(rows));
+    }
+    return rows;
+}
+
+std::vector<ClientRecord> ReadCsvFile(const std::string& filename) {
+    MappedFile file(filename);
+    return ParseCsv(file.View());
+}
+
+} // namespace core
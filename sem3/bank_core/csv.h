@@ -0,0 +1,38 @@
+// csv.h
+#pragma once
+// CSV по RFC 4180 для таблицы клиентов: тип,имя,ставка,сумма (без надбавки VIP).
+// поля с запятой, кавычкой или переводом строки берутся в кавычки, кавычка удваивается
+#include "client_record.h"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace core {
+
+// ошибка разбора с номером строки файла (с 1, переводы строк внутри кавычек тоже считаются)
+class CsvError : public std::runtime_error {
+private:
+    int64_t line;
+
+public:
+    CsvError(int64_t line, const std::string& what)
+        : std::runtime_error("строка " + std::to_string(line) + ": " + what), line(line) {
+    }
+
+    int64_t Line() const { return line; }
+};
+
+// запись одной строки в конец out (с CRLF)
+void AppendCsvRow(std::string& out, const ClientRecord& c);
+
+// большой текст режется на куски по границам записей и разбирается в нескольких потоках.
+// при первой же ошибке бросает CsvError, ошибка с наименьшим номером строки
+std::vector<ClientRecord> ParseCsv(std::string_view data);
+
+// файловые версии, имена файлов в UTF-8
+void WriteCsvFile(const std::vector<ClientRecord>& clients, const std::string& filename);
+std::vector<ClientRecord> ReadCsvFile(const std::string& filename);
+
+} // namespace core
@@ -0,0 +1,32 @@
+// mapped_file.h
+#pragma once
+// файл, отображённый в память только для чтения (mmap / MapViewOfFile)
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace core {
+
+class MappedFile {
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    void Close();
+
+public:
+    // filename в UTF-8; бросает std::runtime_error, если файл не открылся
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view View() const { return std::string_view(data, size); }
+};
+
+} // namespace core
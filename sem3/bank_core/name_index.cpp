@@ -0,0 +1,150 @@
+// name_index.cpp
+#include "name_index.h"
+#include "text.h"
+#include <algorithm>
+
+namespace core {
+
+// по кодовой точке: байты UTF-8 после первого всегда >= 0x80, поэтому годится и для отдельных байт
+static bool IsSeparator(uint32_t cp) {
+    return cp == ' ' || cp == '-';
+}
+
+// начала слов в ключе (байтовые позиции)
+static std::vector<size_t> WordStarts(const std::string& key) {
+    std::vector<size_t> starts;
+    for (size_t i = 0; i < key.size(); ++i) {
+        uint32_t c = static_cast<unsigned char>(key[i]);
+        if (!IsSeparator(c) && (i == 0 || IsSeparator(static_cast<unsigned char>(key[i - 1])))) starts.push_back(i);
+    }
+    return starts;
+}
+
+// триграммы кодовых точек ключа, как в pg_trgm: в начале два пробела, в конце один
+static std::vector<uint64_t> Trigrams(const std::string& key) {
+    std::vector<uint32_t> cps = { ' ', ' ' };
+    for (size_t i = 0; i < key.size();) {
+        unsigned char c = static_cast<unsigned char>(key[i]);
+        uint32_t cp = c;
+        size_t len = 1;
+        if (c >= 0xF0) { cp = c & 0x07; len = 4; }
+        else if (c >= 0xE0) { cp = c & 0x0F; len = 3; }
+        else if (c >= 0xC0) { cp = c & 0x1F; len = 2; }
+        for (size_t k = 1; k < len && i + k < key.size(); ++k)
+            cp = (cp << 6) | (static_cast<unsigned char>(key[i + k]) & 0x3F);
+        i += len;
+        cps.push_back(IsSeparator(cp) ? ' ' : cp);
+    }
+    cps.push_back(' ');
+
+    std::vector<uint64_t> out;
+    for (size_t i = 0; i + 2 < cps.size(); ++i) {
+        out.push_back((uint64_t(cps[i]) << 42) | (uint64_t(cps[i + 1]) << 21) | cps[i + 2]);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+NameIndex::NameIndex(BankSystem& bank, bool fuzzy) : bank(bank), fuzzy(fuzzy) {
+    Rebuild();
+    bank.AddObserver(this);
+}
+
+NameIndex::~NameIndex() {
+    bank.RemoveObserver(this);
+}
+
+void NameIndex::Insert(const std::string& name, ClientHandle h) {
+    std::string key = CollationKey(name);
+    for (size_t start : WordStarts(key)) words.emplace(key.substr(start), h);
+    if (!fuzzy) return;
+    for (uint64_t t : Trigrams(key)) trigrams[t].insert(h);
+}
+
+void NameIndex::Erase(const std::string& name, ClientHandle h) {
+    std::string key = CollationKey(name);
+    for (size_t start : WordStarts(key)) words.erase({ key.substr(start), h });
+    if (!fuzzy) return;
+    for (uint64_t t : Trigrams(key)) {
+        auto it = trigrams.find(t);
+        if (it == trigrams.end()) continue;
+        it->second.erase(h);
+        if (it->second.empty()) trigrams.erase(it);
+    }
+}
+
+void NameIndex::Rebuild() {
+    words.clear();
+    trigrams.clear();
+    for (int i = 0; i < bank.Count(); ++i) Insert(bank.GetClient(i).name, bank.GetHandle(i));
+}
+
+std::vector<ClientHandle> NameIndex::FindPrefix(std::string_view prefix, size_t limit) const {
+    std::vector<ClientHandle> found;
+    std::string key = CollationKey(prefix);
+    if (key.empty()) return found;
+
+    // у одного клиента префикс может совпасть с несколькими словами
+    std::unordered_set<ClientHandle> seen;
+    for (auto it = words.lower_bound({ key, 0 }); it != words.end() && found.size() < limit; ++it) {
+        if (it->first.compare(0, key.size(), key) != 0) break;
+        if (seen.insert(it->second).second) found.push_back(it->second);
+    }
+    return found;
+}
+
+std::vector<ClientHandle> NameIndex::FindFuzzy(std::string_view query, size_t limit,
+                                               double minScore) const {
+    std::vector<ClientHandle> found;
+    if (!fuzzy) return found;
+    std::vector<uint64_t> grams = Trigrams(CollationKey(query));
+
+    std::unordered_map<ClientHandle, int> shared;
+    for (uint64_t t : grams) {
+        auto it = trigrams.find(t);
+        if (it == trigrams.end()) continue;
+        for (ClientHandle h : it->second) ++shared[h];
+    }
+
+    // сходство по Жаккару: общие / все различные триграммы обоих имён
+    std::vector<std::pair<double, ClientHandle>> ranked;
+    for (const auto& [h, common] : shared) {
+        int index = bank.IndexOf(h);
+        if (index < 0) continue;
+        size_t own = Trigrams(CollationKey(bank.GetClient(index).name)).size();
+        double score = double(common) / double(grams.size() + own - common);
+        if (score >= minScore) ranked.emplace_back(score, h);
+    }
+    size_t n = std::min(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(),
+                      [](const auto& a, const auto& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+    for (size_t i = 0; i < n; ++i) found.push_back(ranked[i].second);
+    return found;
+}
+
+void NameIndex::OnInserted(int index, ClientHandle h) {
+    Insert(bank.GetClient(index).name, h);
+}
+
+void NameIndex::OnUpdated(int index, ClientHandle h, const ClientRecord& before) {
+    const std::string& name = bank.GetClient(index).name;
+    if (name == before.name) return;
+    Erase(before.name, h);
+    Insert(name, h);
+}
+
+void NameIndex::OnRemoved(int, ClientHandle h, const ClientRecord& removed, int) {
+    Erase(removed.name, h);
+}
+
+void NameIndex::OnReset() {
+    Rebuild();
+}
+
+void NameIndex::OnReordered() {
+}
+
+} // namespace core
@@ -0,0 +1,54 @@
+// name_index.h
+#pragma once
+// индекс имён клиентов для поиска по мере ввода: без учёта регистра (CollationKey),
+// по началу любого слова имени ("иван" найдёт и "Иванов Пётр", и "Петров Иван").
+// подписан на BankSystem и обновляется на каждое добавление/изменение/удаление за O(log n);
+// сортировка индекс не трогает: он хранит идентификаторы клиентов, а не номера строк.
+// нечёткий поиск по триграммам (опечатки) включается отдельно - он занимает заметно больше памяти
+#include "bank_core.h"
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace core {
+
+class NameIndex : public BankObserver {
+    BankSystem& bank;
+    bool fuzzy;
+
+    // ключ - CollationKey имени начиная с очередного слова
+    std::set<std::pair<std::string, ClientHandle>> words;
+    // триграмма (три кодовые точки ключа) -> клиенты, у которых она есть
+    std::unordered_map<uint64_t, std::unordered_set<ClientHandle>> trigrams;
+
+    void Insert(const std::string& name, ClientHandle h);
+    void Erase(const std::string& name, ClientHandle h);
+    void Rebuild();
+
+public:
+    explicit NameIndex(BankSystem& bank, bool fuzzy = false);
+    ~NameIndex() override;
+    NameIndex(const NameIndex&) = delete;
+    NameIndex& operator=(const NameIndex&) = delete;
+
+    // не больше limit клиентов, у которых какое-то слово имени начинается с prefix,
+    // по алфавиту найденного слова; пустой prefix - ничего
+    std::vector<ClientHandle> FindPrefix(std::string_view prefix, size_t limit = 20) const;
+    // похожие имена по доле общих триграмм (не меньше minScore), лучшие сначала;
+    // без fuzzy в конструкторе всегда пусто
+    std::vector<ClientHandle> FindFuzzy(std::string_view query, size_t limit = 20,
+                                        double minScore = 0.3) const;
+
+    void OnInserted(int index, ClientHandle h) override;
+    void OnUpdated(int index, ClientHandle h, const ClientRecord& before) override;
+    void OnRemoved(int index, ClientHandle h, const ClientRecord& removed, int movedFrom) override;
+    void OnReset() override;
+    void OnReordered() override;
+};
+
+} // namespace core
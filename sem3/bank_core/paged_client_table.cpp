@@ -0,0 +1,103 @@
+// paged_client_table.cpp
+#include "paged_client_table.h"
+#include "sqlite_common.h"
+#include <stdexcept>
+
+namespace core {
+
+PagedClientTable::PagedClientTable(const std::string& filename, int rowsPerPage)
+    : pageSize(rowsPerPage > 0 ? rowsPerPage : 1000) {
+    db = OpenDatabase(filename, false);
+    if (!HasTable(db, "Clients")) return; // пустая база: count = 0, запросы не нужны
+    count = ReadRowCount(db);
+
+    if (sqlite3_prepare_v3(db,
+            "SELECT id, is_vip, name, rate, amount_base FROM Clients "
+            "WHERE id > ? ORDER BY id LIMIT ?;",
+            -1, SQLITE_PREPARE_PERSISTENT, &afterIdStmt, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v3(db,
+            "SELECT id, is_vip, name, rate, amount_base FROM Clients "
+            "ORDER BY id LIMIT ? OFFSET ?;",
+            -1, SQLITE_PREPARE_PERSISTENT, &offsetStmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(afterIdStmt);
+        Fail(db, "ошибка запроса к базе");
+    }
+}
+
+PagedClientTable::~PagedClientTable() {
+    Close();
+}
+
+void PagedClientTable::Close() {
+    sqlite3_finalize(afterIdStmt);
+    sqlite3_finalize(offsetStmt);
+    sqlite3_close(db);
+    afterIdStmt = offsetStmt = nullptr;
+    db = nullptr;
+}
+
+const ClientRecord& PagedClientTable::Get(int64_t index) {
+    if (index < 0 || index >= count)
+        throw std::out_of_range("номер строки вне таблицы");
+
+    const Page& page = LoadPage(index / pageSize);
+    size_t offset = static_cast<size_t>(index % pageSize);
+    if (offset >= page.rows.size())
+        throw std::out_of_range("таблица изменилась после открытия");
+    return page.rows[offset];
+}
+
+const PagedClientTable::Page& PagedClientTable::LoadPage(int64_t number) {
+    for (auto& p : cache) {
+        if (p.number == number) {
+            p.lastUse = ++useClock;
+            return p;
+        }
+    }
+
+    // вытесняем давно не использованную страницу
+    Page* slot = nullptr;
+    if (cache.size() < maxCachedPages) {
+        cache.emplace_back();
+        slot = &cache.back();
+    }
+    else {
+        slot = &cache[0];
+        for (auto& p : cache) {
+            if (p.lastUse < slot->lastUse) slot = &p;
+        }
+    }
+    slot->number = number;
+    slot->lastUse = ++useClock;
+    slot->rows.clear();
+
+    // если предыдущая страница уже читалась - идём по индексу id, иначе через OFFSET
+    sqlite3_stmt* stmt;
+    auto prev = pageLastId.find(number - 1);
+    if (number == 0 || prev != pageLastId.end()) {
+        stmt = afterIdStmt;
+        sqlite3_bind_int64(stmt, 1, number == 0 ? INT64_MIN : prev->second);
+        sqlite3_bind_int(stmt, 2, pageSize);
+    }
+    else {
+        stmt = offsetStmt;
+        sqlite3_bind_int(stmt, 1, pageSize);
+        sqlite3_bind_int64(stmt, 2, number * pageSize);
+    }
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        slot->rows.push_back(ReadClient(stmt));
+    }
+    sqlite3_reset(stmt);
+    if (rc != SQLITE_DONE) {
+        slot->number = -1;
+        throw std::runtime_error(std::string("ошибка чтения страницы: ") + sqlite3_errmsg(db));
+    }
+
+    if (!slot->rows.empty())
+        pageLastId[number] = slot->rows.back().id;
+    return *slot;
+}
+
+} // namespace core
@@ -0,0 +1,55 @@
+// paged_client_table.h
+#pragma once
+// чтение таблицы Clients страницами, без загрузки всей базы в память.
+// клиенты создаются только при обращении к их странице
+#include "client_record.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace core {
+
+class PagedClientTable {
+private:
+    struct Page {
+        int64_t number = -1;
+        std::vector<ClientRecord> rows;
+        uint64_t lastUse = 0;
+    };
+
+    sqlite3* db = nullptr;
+    sqlite3_stmt* afterIdStmt = nullptr; // следующая страница по ключу: id > ?
+    sqlite3_stmt* offsetStmt = nullptr;  // переход на произвольную страницу
+    int pageSize;
+    int64_t count = 0;
+    uint64_t useClock = 0;
+
+    std::vector<Page> cache;              // не больше maxCachedPages страниц
+    std::map<int64_t, int64_t> pageLastId; // последний id уже прочитанных страниц
+
+    static constexpr size_t maxCachedPages = 4;
+
+    const Page& LoadPage(int64_t number);
+    void Close();
+
+public:
+    // бросает std::runtime_error, если базу не удалось открыть
+    explicit PagedClientTable(const std::string& filename, int rowsPerPage = 1000);
+    ~PagedClientTable();
+
+    PagedClientTable(const PagedClientTable&) = delete;
+    PagedClientTable& operator=(const PagedClientTable&) = delete;
+
+    // число строк читается один раз при открытии (из ClientsInfo, см. ReadRowCount)
+    int64_t Count() const { return count; }
+    int PageSize() const { return pageSize; }
+
+    // строка по номеру в порядке id; ссылка живёт до следующего вызова Get
+    const ClientRecord& Get(int64_t index);
+};
+
+} // namespace core
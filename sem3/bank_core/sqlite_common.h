@@ -0,0 +1,26 @@
+// sqlite_common.h
+#pragma once
+// общие функции для работы с таблицей Clients, только для .cpp ядра
+#include "client_record.h"
+#include "sqlite3.h"
+#include <string>
+
+namespace core {
+
+// закрывает базу и бросает std::runtime_error с текстом последней ошибки
+[[noreturn]] void Fail(sqlite3* db, const std::string& what);
+
+// create = true: создать файл и таблицу при отсутствии (для сохранения).
+// create = false: файл должен существовать, схема не трогается
+sqlite3* OpenDatabase(const std::string& filename, bool create);
+
+bool HasTable(sqlite3* db, const char* name);
+
+// число клиентов, записанное в ClientsInfo при сохранении, за O(1);
+// в базах без ClientsInfo - count(*) по таблице
+int64_t ReadRowCount(sqlite3* db);
+
+// столбцы id, is_vip, name, rate, amount_base начиная с первого
+ClientRecord ReadClient(sqlite3_stmt* stmt);
+
+} // namespace core
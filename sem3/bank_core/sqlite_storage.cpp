@@ -0,0 +1,290 @@
+// sqlite_storage.cpp
+#include "sqlite_storage.h"
+#include "sqlite_common.h"
+#include "columnar.h"
+#include <stdexcept>
+
+namespace core {
+
+// схема создаётся при сохранении. покрывающий индекс ClientsIncome нужен SummarizeDatabase:
+// итоги по доходу читаются из него, без обхода таблицы
+static const char* createTableSQL = R"(
+    CREATE TABLE IF NOT EXISTS Clients (
+        id INTEGER PRIMARY KEY AUTOINCREMENT,
+        is_vip INTEGER NOT NULL,
+        name TEXT NOT NULL,
+        rate INTEGER NOT NULL,
+        amount_base INTEGER NOT NULL
+    );
+    CREATE TABLE IF NOT EXISTS ClientsInfo (
+        id INTEGER PRIMARY KEY CHECK (id = 1),
+        row_count INTEGER NOT NULL
+    );
+    CREATE INDEX IF NOT EXISTS ClientsIncome ON Clients (is_vip, rate, amount_base);
+)";
+
+void Fail(sqlite3* db, const std::string& what) {
+    std::string msg = what + ": " + (db ? sqlite3_errmsg(db) : "нет памяти");
+    sqlite3_close(db);
+    throw std::runtime_error(msg);
+}
+
+sqlite3* OpenDatabase(const std::string& filename, bool create) {
+    sqlite3* db = nullptr;
+    int flags = SQLITE_OPEN_READWRITE | (create ? SQLITE_OPEN_CREATE : 0);
+    if (sqlite3_open_v2(filename.c_str(), &db, flags, nullptr) != SQLITE_OK)
+        Fail(db, "не удалось открыть базу " + filename);
+    if (create && sqlite3_exec(db, createTableSQL, nullptr, nullptr, nullptr) != SQLITE_OK)
+        Fail(db, "ошибка создания таблицы");
+    return db;
+}
+
+bool HasTable(sqlite3* db, const char* name) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db,
+            "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?;",
+            -1, &stmt, nullptr) != SQLITE_OK)
+        Fail(db, "ошибка запроса к базе");
+    sqlite3_bind_text(stmt, 1, name, -1, SQLITE_STATIC);
+    bool found = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+// одно целое из первой строки запроса; found = false, если строк нет
+static int64_t QueryInt(sqlite3* db, const char* sql, bool& found) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        Fail(db, "ошибка запроса к базе");
+    int rc = sqlite3_step(stmt);
+    found = rc == SQLITE_ROW;
+    int64_t value = found ? sqlite3_column_int64(stmt, 0) : 0;
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) Fail(db, "ошибка запроса к базе");
+    return value;
+}
+
+int64_t ReadRowCount(sqlite3* db) {
+    bool found = false;
+    if (HasTable(db, "ClientsInfo")) {
+        int64_t count = QueryInt(db, "SELECT row_count FROM ClientsInfo WHERE id = 1;", found);
+        if (found) return count;
+    }
+    // база записана старой версией: считаем строки
+    return QueryInt(db, "SELECT count(*) FROM Clients;", found);
+}
+
+ClientRecord ReadClient(sqlite3_stmt* stmt) {
+    ClientRecord c;
+    c.id = sqlite3_column_int64(stmt, 0);
+    c.vip = sqlite3_column_int(stmt, 1) != 0;
+    const unsigned char* name = sqlite3_column_text(stmt, 2);
+    c.name.assign(name ? reinterpret_cast<const char*>(name) : "",
+        static_cast<size_t>(sqlite3_column_bytes(stmt, 2)));
+    c.rate = sqlite3_column_int(stmt, 3);
+    c.amount = sqlite3_column_int(stmt, 4);
+    return c;
+}
+
+static void Exec(sqlite3* db, const char* sql, const char* what) {
+    if (sqlite3_exec(db, sql, nullptr, nullptr, nullptr) != SQLITE_OK)
+        Fail(db, what);
+}
+
+static sqlite3_stmt* Prepare(sqlite3* db, const char* sql) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK)
+        Fail(db, "ошибка подготовки запроса");
+    return stmt;
+}
+
+static void BindClient(sqlite3_stmt* stmt, const ClientRecord& c, int64_t id) {
+    sqlite3_bind_int64(stmt, 1, id);
+    sqlite3_bind_int(stmt, 2, c.vip ? 1 : 0);
+    // имя уже в UTF-8 и живёт дольше шага запроса - копия не нужна
+    sqlite3_bind_text(stmt, 3, c.name.data(), static_cast<int>(c.name.size()), SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 4, c.rate);
+    sqlite3_bind_int(stmt, 5, c.amount);
+}
+
+static void Step(sqlite3* db, sqlite3_stmt* stmt, const char* what) {
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        sqlite3_finalize(stmt);
+        Fail(db, what);
+    }
+    sqlite3_reset(stmt);
+}
+
+static const char* insertSQL =
+    "INSERT INTO Clients (id, is_vip, name, rate, amount_base) VALUES (?, ?, ?, ?, ?);";
+
+// переписать таблицу целиком в текущем порядке; id - номер строки, как после RenumberIds
+static void WriteAll(sqlite3* db, const std::vector<ClientRecord>& clients) {
+    Exec(db, "DELETE FROM Clients;", "ошибка очистки таблицы");
+
+    sqlite3_stmt* stmt = Prepare(db, insertSQL);
+    for (size_t i = 0; i < clients.size(); ++i) {
+        BindClient(stmt, clients[i], static_cast<int64_t>(i) + 1);
+        Step(db, stmt, "ошибка вставки клиента");
+    }
+    sqlite3_finalize(stmt);
+}
+
+// только изменённые строки: DELETE для удалённых, INSERT для новых, UPSERT для изменённых
+static void WriteChanges(sqlite3* db, const std::vector<ClientRecord>& clients, const ChangeSet& changes) {
+    if (!changes.removed.empty()) {
+        sqlite3_stmt* del = Prepare(db, "DELETE FROM Clients WHERE id = ?;");
+        for (int64_t id : changes.removed) {
+            sqlite3_bind_int64(del, 1, id);
+            Step(db, del, "ошибка удаления клиента");
+        }
+        sqlite3_finalize(del);
+    }
+
+    if (changes.added.empty() && changes.updated.empty()) return;
+
+    sqlite3_stmt* ins = Prepare(db, insertSQL);
+    sqlite3_stmt* upd = Prepare(db,
+        "INSERT INTO Clients (id, is_vip, name, rate, amount_base) VALUES (?, ?, ?, ?, ?) "
+        "ON CONFLICT(id) DO UPDATE SET is_vip = excluded.is_vip, name = excluded.name, "
+        "rate = excluded.rate, amount_base = excluded.amount_base;");
+    for (const auto& c : clients) {
+        sqlite3_stmt* stmt = changes.added.count(c.id) ? ins
+            : changes.updated.count(c.id) ? upd : nullptr;
+        if (!stmt) continue;
+        BindClient(stmt, c, c.id);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            sqlite3_finalize(ins);
+            sqlite3_finalize(upd);
+            Fail(db, "ошибка записи клиента");
+        }
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(ins);
+    sqlite3_finalize(upd);
+}
+
+// файл с последней синхронизации могли удалить или подменить (OpenDatabase тогда создаст пустую
+// таблицу): изменения пишутся, только если в базе столько строк, сколько было при синхронизации
+static bool MatchesLastSync(sqlite3* db, size_t count, const ChangeSet& changes) {
+    int64_t synced = static_cast<int64_t>(count) - static_cast<int64_t>(changes.added.size())
+        + static_cast<int64_t>(changes.removed.size());
+    return ReadRowCount(db) == synced;
+}
+
+// всё пишется в одной транзакции: одна синхронизация журнала на сохранение,
+// а не на каждую строку. незакоммиченная транзакция откатывается при sqlite3_close
+bool WriteDatabase(const std::vector<ClientRecord>& clients, const ChangeSet& changes, bool synced,
+    const std::string& filename) {
+    bool incremental = synced && !changes.reset;
+
+    sqlite3* db = OpenDatabase(filename, true);
+
+    // WAL + NORMAL: при сбое питания теряется максимум последнее сохранение, файл не портится
+    Exec(db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", "ошибка настройки базы");
+    Exec(db, "BEGIN IMMEDIATE;", "ошибка начала транзакции");
+
+    // проверка внутри транзакции: между ней и записью базу никто не поменяет
+    if (incremental && !MatchesLastSync(db, clients.size(), changes)) incremental = false;
+    if (incremental && changes.Empty()) {
+        sqlite3_close(db);
+        return false;
+    }
+
+    if (incremental)
+        WriteChanges(db, clients, changes);
+    else
+        WriteAll(db, clients);
+
+    sqlite3_stmt* info = Prepare(db,
+        "INSERT INTO ClientsInfo (id, row_count) VALUES (1, ?) "
+        "ON CONFLICT(id) DO UPDATE SET row_count = excluded.row_count;");
+    sqlite3_bind_int64(info, 1, static_cast<int64_t>(clients.size()));
+    Step(db, info, "ошибка записи числа клиентов");
+    sqlite3_finalize(info);
+
+    Exec(db, "COMMIT;", "ошибка сохранения транзакции");
+    sqlite3_close(db);
+    return !incremental;
+}
+
+void SaveToDatabase(BankSystem& bank, const std::string& filename) {
+    if (WriteDatabase(bank.GetClients(), bank.GetChanges(), bank.GetSyncedFile() == filename, filename))
+        bank.RenumberIds();
+    bank.MarkSynced(filename);
+}
+
+void LoadFromDatabase(BankSystem& bank, const std::string& filename) {
+    sqlite3* db = OpenDatabase(filename, false);
+    if (!HasTable(db, "Clients")) {
+        sqlite3_close(db);
+        bank.Assign({});
+        bank.MarkSynced(filename);
+        return;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db,
+            "SELECT id, is_vip, name, rate, amount_base FROM Clients ORDER BY id;",
+            -1, &stmt, nullptr) != SQLITE_OK)
+        Fail(db, "ошибка запроса к базе");
+
+    std::vector<ClientRecord> loaded;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        loaded.push_back(ReadClient(stmt));
+    }
+
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) Fail(db, "ошибка чтения клиентов");
+    sqlite3_close(db);
+    bank.Assign(std::move(loaded));
+    bank.MarkSynced(filename);
+}
+
+IncomeSummary SummarizeDatabase(const std::string& filename) {
+    IncomeSummary s;
+    sqlite3* db = OpenDatabase(filename, false);
+    if (!HasTable(db, "Clients")) {
+        sqlite3_close(db);
+        return s;
+    }
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db,
+            "SELECT is_vip <> 0 AS vip, count(*), "
+            "sum(rate * (amount_base + CASE WHEN is_vip <> 0 THEN 1000 ELSE 0 END)) "
+            "FROM Clients GROUP BY vip;",
+            -1, &stmt, nullptr) != SQLITE_OK)
+        Fail(db, "ошибка запроса к базе");
+
+    // ошибка посреди выборки (например, переполнение sum) не должна выглядеть как конец данных
+    int64_t vipSum = 0, simpleSum = 0;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        int64_t n = sqlite3_column_int64(stmt, 1);
+        int64_t sum = sqlite3_column_int64(stmt, 2);
+        s.count += n;
+        if (sqlite3_column_int(stmt, 0) != 0) {
+            s.vipCount = n;
+            vipSum = sum;
+        }
+        else {
+            simpleSum = sum;
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) Fail(db, "ошибка подсчёта итогов");
+    sqlite3_close(db);
+
+    s.vipIncome = vipSum / 100.0;
+    s.totalIncome = (vipSum + simpleSum) / 100.0;
+    return s;
+}
+
+void ConvertDatabaseToColumnar(const std::string& dbFile, const std::string& columnarFile) {
+    BankSystem bank;
+    LoadFromDatabase(bank, dbFile);
+    SaveToColumnar(bank, columnarFile);
+}
+
+} // namespace core
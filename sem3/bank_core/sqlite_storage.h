@@ -0,0 +1,29 @@
+// sqlite_storage.h
+#pragma once
+// хранение клиентов в SQLite (формат laba5: таблица Clients)
+#include "bank_core.h"
+#include <string>
+#include <vector>
+
+namespace core {
+
+// при ошибках SQLite бросают std::runtime_error с текстом sqlite3_errmsg.
+// если bank загружен из этой же базы (или уже сохранён в неё) и в ней столько же строк, сколько
+// было тогда, пишутся только изменения из bank.GetChanges(); иначе таблица переписывается целиком
+void SaveToDatabase(BankSystem& bank, const std::string& filename);
+void LoadFromDatabase(BankSystem& bank, const std::string& filename);
+
+// запись SaveToDatabase без BankSystem - для сохранения копии на другом потоке (AsyncBankSystem).
+// synced: банк синхронизирован с filename. возвращает true, если таблица переписана целиком
+// (id = номер строки): тогда у банка нужно вызвать RenumberIds; после записи - MarkSynced(filename)
+bool WriteDatabase(const std::vector<ClientRecord>& clients, const ChangeSet& changes, bool synced,
+    const std::string& filename);
+
+// итоги считаются агрегатами SQL прямо по таблице, клиенты в память не загружаются, база не меняется.
+// правило VIP (+1000 к сумме) то же, что в ClientRecord::EffectiveAmount; итоги совпадают с BankSystem::Summarize
+IncomeSummary SummarizeDatabase(const std::string& filename);
+
+// перевод базы laba5 в колоночный формат .bcol (см. columnar.h)
+void ConvertDatabaseToColumnar(const std::string& dbFile, const std::string& columnarFile);
+
+} // namespace core
@@ -0,0 +1,93 @@
+// async_storage_test.cpp
+// AsyncBankSystem: пока база пишется на пуле, сопрограмма на потоке Executor читает банк, а Modify ждёт;
+// после сохранения id и изменения те же, что после SaveToDatabase
+#include "test_util.h"
+#include "async_storage.h"
+#include "sqlite_storage.h"
+#include <vector>
+
+using core::AsyncBankSystem;
+using core::BankSystem;
+using core::Executor;
+using core::Task;
+using core::ThreadPool;
+
+namespace {
+
+core::ClientRecord Client(int i) {
+    core::ClientRecord c;
+    c.name = "клиент " + std::to_string(i);
+    c.rate = 1 + i % 13;
+    c.amount = 100 + i;
+    return c;
+}
+
+Task<void> Save(AsyncBankSystem& system, std::string path, bool& saved) {
+    co_await system.Save(path);
+    saved = true;
+}
+
+// читает id и суммы, пока идёт сохранение (перенумерация на пуле была бы гонкой с этим чтением)
+Task<void> Reads(Executor& exec, const BankSystem& bank, const bool& saved, int& reads) {
+    while (!saved) {
+        int64_t ids = 0;
+        for (const auto& c : bank.GetClients()) ids += c.id;
+        CHECK(ids > 0);
+        ++reads;
+        co_await exec.Schedule();
+    }
+}
+
+Task<void> Adds(AsyncBankSystem& system, const bool& saved) {
+    co_await system.Modify([&saved](BankSystem& b) {
+        CHECK(saved);
+        b.AddClient(Client(-1));
+    });
+}
+
+void CheckReloads(const BankSystem& bank, const std::string& path) {
+    BankSystem loaded;
+    core::LoadFromDatabase(loaded, path);
+    CHECK(loaded.Count() == bank.Count());
+    for (int i = 0; i < bank.Count(); ++i) {
+        CHECK(loaded.GetClient(i) == bank.GetClient(i));
+        CHECK(loaded.GetClient(i).id == bank.GetClient(i).id);
+    }
+}
+
+void SaveWhileReading() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    for (int i = 0; i < 20000; ++i) bank.AddClient(Client(i));
+    bank.Sort({ { core::SortField::Amount, false } });
+
+    Executor exec;
+    ThreadPool pool(1);
+    AsyncBankSystem system(bank, exec, pool);
+    bool saved = false;
+    int reads = 0;
+    exec.Spawn(Save(system, db.Path(), saved));
+    exec.Spawn(Reads(exec, bank, saved, reads));
+    exec.Spawn(Adds(system, saved));
+    exec.Run();
+
+    // таблица переписана (после сортировки): id по порядку, добавленный позже - в изменениях
+    CHECK(reads > 0);
+    CHECK(bank.GetSyncedFile() == db.Path());
+    CHECK(bank.Count() == 20001);
+    CHECK(bank.GetClient(0).id == 1 && bank.GetClient(19999).id == 20000);
+    CHECK(bank.GetChanges().added.size() == 1 && !bank.GetChanges().reset);
+
+    saved = false;
+    exec.Spawn(Save(system, db.Path(), saved));
+    exec.Run();
+    CHECK(bank.GetChanges().Empty());
+    CheckReloads(bank, db.Path());
+}
+
+} // namespace
+
+int main() {
+    SaveWhileReading();
+    return 0;
+}
@@ -0,0 +1,143 @@
+// async_test.cpp
+// Task, Executor, ThreadPool, AsyncMutex: исключения доходят до co_await и до Run(), блокировка
+// передаётся ожидающим по очереди, Run() возвращается только после всех запущенных через Spawn
+#include "test_util.h"
+#include "async.h"
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using core::AsyncMutex;
+using core::Executor;
+using core::Task;
+using core::ThreadPool;
+
+namespace {
+
+Task<int> Twice(int x) {
+    co_return x * 2;
+}
+
+Task<int> Fails() {
+    throw std::runtime_error("вложенная");
+    co_return 0;
+}
+
+Task<void> Nested(Executor& exec, ThreadPool& pool, std::vector<std::string>& log) {
+    log.push_back(std::to_string(co_await Twice(21)));
+    try {
+        co_await Fails();
+    }
+    catch (const std::runtime_error& e) {
+        log.push_back(e.what());
+    }
+    try {
+        co_await pool.Run(exec, []() -> int { throw std::runtime_error("в пуле"); });
+    }
+    catch (const std::runtime_error& e) {
+        log.push_back(e.what());
+    }
+}
+
+Task<void> Throws(Executor& exec, const char* what) {
+    co_await exec.Schedule();
+    throw std::runtime_error(what);
+}
+
+Task<void> Appends(Executor& exec, std::vector<int>& out, int value) {
+    co_await exec.Schedule();
+    co_await exec.Schedule();
+    out.push_back(value);
+}
+
+void ExceptionsPropagate() {
+    Executor exec;
+    ThreadPool pool(1);
+    std::vector<std::string> log;
+    exec.Spawn(Nested(exec, pool, log));
+    exec.Run();
+    CHECK((log == std::vector<std::string>{ "42", "вложенная", "в пуле" }));
+
+    // Run() бросает первое исключение запущенных задач, но только когда завершились все
+    std::vector<int> done;
+    exec.Spawn(Throws(exec, "первая"));
+    exec.Spawn(Appends(exec, done, 1));
+    exec.Spawn(Throws(exec, "вторая"));
+    std::string error;
+    try {
+        exec.Run();
+    }
+    catch (const std::runtime_error& e) {
+        error = e.what();
+    }
+    CHECK(error == "первая");
+    CHECK((done == std::vector<int>{ 1 }));
+
+    // ошибка не переходит на следующий Run()
+    exec.Spawn(Appends(exec, done, 2));
+    exec.Run();
+    CHECK((done == std::vector<int>{ 1, 2 }));
+}
+
+// держит блокировку несколько ходов Executor, чтобы остальные успели встать в очередь
+Task<void> Holds(Executor& exec, AsyncMutex& mutex, std::vector<int>& order, int id, int turns) {
+    auto lock = co_await mutex.Lock();
+    order.push_back(id);
+    for (int i = 0; i < turns; ++i) co_await exec.Schedule();
+}
+
+Task<void> HoldsThenSpawns(Executor& exec, AsyncMutex& mutex, std::vector<int>& order) {
+    auto lock = co_await mutex.Lock();
+    order.push_back(1);
+    co_await exec.Schedule();
+    co_await exec.Schedule();
+    // опоздавший просит блокировку после Unlock, но раньше, чем проснётся первый ожидающий
+    exec.Spawn(Holds(exec, mutex, order, 4, 0));
+}
+
+void MutexHandsOffInOrder() {
+    Executor exec;
+    AsyncMutex mutex(exec);
+    std::vector<int> order;
+    exec.Spawn(HoldsThenSpawns(exec, mutex, order));
+    exec.Spawn(Holds(exec, mutex, order, 2, 2));
+    exec.Spawn(Holds(exec, mutex, order, 3, 0));
+    exec.Run();
+    CHECK((order == std::vector<int>{ 1, 2, 3, 4 }));
+
+    // после всех ожидающих блокировка свободна
+    order.clear();
+    exec.Spawn(Holds(exec, mutex, order, 5, 0));
+    exec.Run();
+    CHECK((order == std::vector<int>{ 5 }));
+}
+
+// ждёт пул и запускает следующие задачи уже после того, как первые вернулись из пула
+Task<void> SlowIo(Executor& exec, ThreadPool& pool, int& finished, int depth) {
+    co_await pool.Run(exec, [] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+    if (depth > 0) exec.Spawn(SlowIo(exec, pool, finished, depth - 1));
+    ++finished;
+}
+
+void RunWaitsForSpawned() {
+    Executor exec;
+    ThreadPool pool(2);
+    int finished = 0;
+    for (int i = 0; i < 3; ++i) exec.Spawn(SlowIo(exec, pool, finished, 2));
+    exec.Run();
+    CHECK(finished == 9);
+
+    // без задач Run() сразу возвращается
+    exec.Run();
+}
+
+} // namespace
+
+int main() {
+    ExceptionsPropagate();
+    MutexHandsOffInOrder();
+    RunWaitsForSpawned();
+    return 0;
+}
@@ -0,0 +1,137 @@
+// columnar_test.cpp
+// .bcol: запись и чтение, а на обрезанном или испорченном файле - std::runtime_error, а не bad_alloc
+#include "test_util.h"
+#include "columnar.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+
+using core::BankSystem;
+
+namespace {
+
+std::string ReadAll(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void WriteAll(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+uint64_t GetU64(const std::string& data, size_t pos) {
+    uint64_t v;
+    std::memcpy(&v, data.data() + pos, sizeof(v));
+    return v;
+}
+
+void PutU64(std::string& data, size_t pos, uint64_t v) {
+    std::memcpy(&data[pos], &v, sizeof(v));
+}
+
+// смещение столбца по каталогу: magic, строк, столбцов, затем (id, смещение, размер)
+size_t ColumnOffset(const std::string& data, uint64_t id) {
+    uint64_t count = GetU64(data, 16);
+    for (uint64_t i = 0; i < count; ++i) {
+        size_t entry = static_cast<size_t>(24 + i * 24);
+        if (GetU64(data, entry) == id) return static_cast<size_t>(GetU64(data, entry + 8));
+    }
+    CHECK(false);
+    return 0;
+}
+
+// загрузка бросает runtime_error; любое другое исключение (в том числе bad_alloc) - ошибка теста
+bool LoadFails(const std::string& path) {
+    BankSystem bank;
+    try {
+        core::LoadFromColumnar(bank, path);
+    }
+    catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+BankSystem MakeBank() {
+    BankSystem bank;
+    for (int i = 0; i < 1000; ++i) {
+        core::ClientRecord c;
+        c.name = "клиент " + std::to_string(i % 300);
+        c.rate = 1 + i % 17;
+        c.amount = 1000 + i * 37;
+        c.vip = i % 4 == 0;
+        bank.AddClient(c);
+    }
+    return bank;
+}
+
+void RoundTrip() {
+    test::TempFile file(".bcol");
+    BankSystem bank = MakeBank();
+    core::SaveToColumnar(bank, file.Path());
+
+    BankSystem loaded;
+    core::LoadFromColumnar(loaded, file.Path());
+    CHECK(loaded.Count() == bank.Count());
+    for (int i = 0; i < bank.Count(); ++i) {
+        CHECK(loaded.GetClient(i) == bank.GetClient(i));
+        CHECK(loaded.GetClient(i).id == bank.GetClient(i).id);
+    }
+    core::IncomeSummary s = core::ColumnarReader(file.Path()).Summarize();
+    CHECK(s.totalIncome == bank.Summarize().totalIncome);
+}
+
+void TruncatedFile() {
+    test::TempFile file(".bcol");
+    core::SaveToColumnar(MakeBank(), file.Path());
+    std::string data = ReadAll(file.Path());
+
+    test::TempFile cut(".bcol");
+    for (size_t size = 1; size < data.size(); size += (size < 64 ? 1 : 97)) {
+        WriteAll(cut.Path(), data.substr(0, size));
+        CHECK(LoadFails(cut.Path()));
+    }
+}
+
+void CorruptedCounts() {
+    test::TempFile file(".bcol");
+    core::SaveToColumnar(MakeBank(), file.Path());
+    const std::string data = ReadAll(file.Path());
+    test::TempFile bad(".bcol");
+
+    // строк в заголовке больше, чем бит в столбце типа
+    std::string rows = data;
+    PutU64(rows, 8, uint64_t(1) << 60);
+    WriteAll(bad.Path(), rows);
+    CHECK(LoadFails(bad.Path()));
+
+    // огромный каталог столбцов
+    std::string columns = data;
+    PutU64(columns, 16, uint64_t(1) << 61);
+    WriteAll(bad.Path(), columns);
+    CHECK(LoadFails(bad.Path()));
+
+    // словарь имён больше числа строк
+    std::string dict = data;
+    PutU64(dict, ColumnOffset(dict, 5), uint64_t(1) << 62);
+    WriteAll(bad.Path(), dict);
+    CHECK(LoadFails(bad.Path()));
+
+    // ширина упаковки сумм (после минимума) такая, что битов не хватает
+    std::string width = data;
+    PutU64(width, ColumnOffset(width, 4) + 8, 63);
+    WriteAll(bad.Path(), width);
+    CHECK(LoadFails(bad.Path()));
+}
+
+} // namespace
+
+int main() {
+    RoundTrip();
+    TruncatedFile();
+    CorruptedCounts();
+    return 0;
+}
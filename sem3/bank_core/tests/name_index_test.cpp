@@ -0,0 +1,107 @@
+// name_index_test.cpp
+// NameIndex следует за BankSystem: добавление, изменение, удаление по одному и пачкой, сортировка;
+// события подписчикам при сортировке и пакетном удалении; триграммы для букв за пределами Latin-1
+#include "test_util.h"
+#include "name_index.h"
+#include <algorithm>
+
+using core::BankSystem;
+using core::ClientHandle;
+using core::NameIndex;
+
+namespace {
+
+ClientHandle Add(BankSystem& bank, const char* name) {
+    core::ClientRecord c;
+    c.name = name;
+    c.rate = 1;
+    c.amount = 100;
+    return bank.AddClient(c);
+}
+
+bool Finds(const NameIndex& index, const char* prefix, ClientHandle h) {
+    std::vector<ClientHandle> found = index.FindPrefix(prefix, 100);
+    return std::find(found.begin(), found.end(), h) != found.end();
+}
+
+// какие события и в каком порядке пришли подписчику
+class Recorder : public core::BankObserver {
+public:
+    int resets = 0;
+    int reorders = 0;
+    std::vector<int> removedRows;
+
+    void OnInserted(int, ClientHandle) override {}
+    void OnUpdated(int, ClientHandle, const core::ClientRecord&) override {}
+    void OnRemoved(int index, ClientHandle, const core::ClientRecord&, int) override { removedRows.push_back(index); }
+    void OnReset() override { ++resets; }
+    void OnReordered() override { ++reorders; }
+};
+
+void FollowsBank() {
+    BankSystem bank;
+    NameIndex index(bank, true);
+    ClientHandle ivanov = Add(bank, "Иванов Пётр");
+    ClientHandle petrov = Add(bank, "Петров Иван");
+    ClientHandle sidorov = Add(bank, "Сидоров-Ёжиков Олег");
+    ClientHandle smith = Add(bank, "John Smith");
+
+    CHECK(Finds(index, "иван", ivanov) && Finds(index, "иван", petrov));
+    CHECK(Finds(index, "ежик", sidorov));
+    CHECK(Finds(index, "SMI", smith));
+
+    core::ClientRecord renamed = bank.GetClient(bank.IndexOf(smith));
+    renamed.name = "Jane Doe";
+    CHECK(bank.UpdateClientById(smith, renamed));
+    CHECK(!Finds(index, "smi", smith) && Finds(index, "doe", smith));
+
+    // сортировка: идентификаторы те же, индекс не перестраивается и продолжает находить клиентов
+    Recorder recorder;
+    bank.AddObserver(&recorder);
+    bank.Sort({ { core::SortField::Name, true } });
+    CHECK(recorder.reorders == 1 && recorder.resets == 0);
+    CHECK(Finds(index, "олег", sidorov));
+    CHECK(bank.GetClient(bank.IndexOf(sidorov)).name == "Сидоров-Ёжиков Олег");
+
+    // пакетное удаление - по событию на клиента, с последней строки
+    int rowIvanov = bank.IndexOf(ivanov);
+    int rowSidorov = bank.IndexOf(sidorov);
+    CHECK(bank.RemoveClients({ ivanov, sidorov }) == 2);
+    CHECK(recorder.resets == 0);
+    CHECK((recorder.removedRows == std::vector<int>{ std::max(rowIvanov, rowSidorov), std::min(rowIvanov, rowSidorov) }));
+    CHECK(!Finds(index, "иванов", ivanov) && !Finds(index, "олег", sidorov));
+    CHECK(Finds(index, "иван", petrov));
+    CHECK(index.FindFuzzy("Сидоров Олег").empty());
+
+    CHECK(bank.RemoveClientById(petrov));
+    CHECK(!Finds(index, "петров", petrov));
+
+    bank.Clear();
+    CHECK(recorder.resets == 1);
+    CHECK(index.FindPrefix("jane").empty());
+    bank.RemoveObserver(&recorder);
+}
+
+// U+0120 и U+012D: младший байт кодовой точки совпадает с ' ' и '-', но это буквы, а не разделители
+void FuzzyKeepsWideCodePoints() {
+    BankSystem bank;
+    NameIndex index(bank, true);
+    ClientHandle wide = Add(bank, "ab\xC4\xA0" "cd");  // abĠcd
+    ClientHandle dash = Add(bank, "ab\xC4\xAD" "cd");  // abĭcd
+    ClientHandle spaced = Add(bank, "ab cd");
+
+    std::vector<ClientHandle> exact = index.FindFuzzy("ab cd", 10, 0.99);
+    CHECK((exact == std::vector<ClientHandle>{ spaced }));
+    exact = index.FindFuzzy("ab\xC4\xA0" "cd", 10, 0.99);
+    CHECK((exact == std::vector<ClientHandle>{ wide }));
+    exact = index.FindFuzzy("ab\xC4\xAD" "cd", 10, 0.99);
+    CHECK((exact == std::vector<ClientHandle>{ dash }));
+}
+
+} // namespace
+
+int main() {
+    FollowsBank();
+    FuzzyKeepsWideCodePoints();
+    return 0;
+}
@@ -0,0 +1,94 @@
+// paged_client_table_test.cpp
+// PagedClientTable на сгенерированной базе: обход страницами подряд, переходы в произвольное место,
+// число строк из ClientsInfo и по count(*) для баз без неё
+#include "test_util.h"
+#include "paged_client_table.h"
+#include "sqlite_storage.h"
+#include "sqlite3.h"
+#include <random>
+#include <stdexcept>
+
+using core::BankSystem;
+using core::PagedClientTable;
+
+namespace {
+
+// клиенты с пропусками в id: часть удалена после первого сохранения
+void Generate(BankSystem& bank, const std::string& path, int count) {
+    std::mt19937 rng(7);
+    for (int i = 0; i < count; ++i) {
+        core::ClientRecord c;
+        c.name = "клиент " + std::to_string(i);
+        c.rate = 1 + static_cast<int>(rng() % 20);
+        c.amount = static_cast<int>(rng() % 100000);
+        c.vip = rng() % 5 == 0;
+        bank.AddClient(c);
+    }
+    core::SaveToDatabase(bank, path);
+    for (int i = bank.Count() - 1; i >= 0; i -= 7) bank.RemoveClient(i);
+    core::SaveToDatabase(bank, path);
+}
+
+void CheckRow(PagedClientTable& table, const BankSystem& bank, int64_t index) {
+    const core::ClientRecord& c = table.Get(index);
+    CHECK(c == bank.GetClient(static_cast<int>(index)));
+    CHECK(c.id == bank.GetClient(static_cast<int>(index)).id);
+}
+
+void Exec(const std::string& path, const char* sql) {
+    sqlite3* db = nullptr;
+    CHECK(sqlite3_open(path.c_str(), &db) == SQLITE_OK);
+    CHECK(sqlite3_exec(db, sql, nullptr, nullptr, nullptr) == SQLITE_OK);
+    sqlite3_close(db);
+}
+
+void PagesThroughTable() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    Generate(bank, db.Path(), 25000);
+
+    PagedClientTable table(db.Path(), 1000);
+    CHECK(table.Count() == bank.Count());
+    for (int64_t i = 0; i < table.Count(); ++i) CheckRow(table, bank, i);
+
+    // прыжки в непрочитанные страницы (OFFSET), назад и в конец
+    PagedClientTable jumps(db.Path(), 512);
+    std::mt19937 rng(11);
+    for (int i = 0; i < 200; ++i) CheckRow(jumps, bank, static_cast<int64_t>(rng() % jumps.Count()));
+    CheckRow(jumps, bank, jumps.Count() - 1);
+    CheckRow(jumps, bank, 0);
+
+    bool thrown = false;
+    try {
+        jumps.Get(jumps.Count());
+    }
+    catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+// базы старых версий без ClientsInfo и файлы без таблицы Clients
+void CountsWithoutInfo() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    Generate(bank, db.Path(), 3000);
+    Exec(db.Path(), "DROP TABLE ClientsInfo;");
+
+    PagedClientTable table(db.Path(), 100);
+    CHECK(table.Count() == bank.Count());
+    CheckRow(table, bank, table.Count() - 1);
+
+    test::TempFile empty(".db");
+    Exec(empty.Path(), "CREATE TABLE Other (x INTEGER);");
+    PagedClientTable none(empty.Path());
+    CHECK(none.Count() == 0);
+}
+
+} // namespace
+
+int main() {
+    PagesThroughTable();
+    CountsWithoutInfo();
+    return 0;
+}
@@ -0,0 +1,255 @@
+// sqlite_storage_test.cpp
+// SaveToDatabase/LoadFromDatabase на временном файле: полная запись, запись изменений, запись после сброса порядка;
+// SummarizeDatabase против BankSystem::Summarize
+#include "test_util.h"
+#include "sqlite_storage.h"
+#include "sqlite3.h"
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using core::BankSystem;
+using core::ClientRecord;
+
+namespace {
+
+ClientRecord Client(const char* name, int rate, int amount, bool vip = false) {
+    ClientRecord c;
+    c.name = name;
+    c.rate = rate;
+    c.amount = amount;
+    c.vip = vip;
+    return c;
+}
+
+// клиенты в базе в порядке id совпадают с банком, включая id
+void CheckReloads(const BankSystem& bank, const std::string& path) {
+    BankSystem loaded;
+    core::LoadFromDatabase(loaded, path);
+    CHECK(loaded.Count() == bank.Count());
+    for (int i = 0; i < bank.Count(); ++i) {
+        CHECK(loaded.GetClient(i) == bank.GetClient(i));
+        CHECK(loaded.GetClient(i).id == bank.GetClient(i).id);
+    }
+    CHECK(loaded.GetChanges().Empty());
+    CHECK(loaded.GetSyncedFile() == path);
+}
+
+std::string QueryText(const std::string& path, const char* sql) {
+    sqlite3* db = nullptr;
+    CHECK(sqlite3_open(path.c_str(), &db) == SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    CHECK(sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK);
+    CHECK(sqlite3_step(stmt) == SQLITE_ROW);
+    const unsigned char* text = sqlite3_column_text(stmt, 0);
+    std::string result = text ? reinterpret_cast<const char*>(text) : "";
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return result;
+}
+
+std::vector<int64_t> Ids(const BankSystem& bank) {
+    std::vector<int64_t> ids;
+    for (const auto& c : bank.GetClients()) ids.push_back(c.id);
+    return ids;
+}
+
+void FullSaveAndReload() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    bank.AddClient(Client("Иванов Иван", 5, 1000));
+    bank.AddClient(Client("Petrov", 7, 2500, true));
+    bank.AddClient(Client("Сидорова Анна", 3, 700));
+
+    core::SaveToDatabase(bank, db.Path());
+    CHECK(bank.GetChanges().Empty());
+    CHECK(bank.GetSyncedFile() == db.Path());
+    CHECK((Ids(bank) == std::vector<int64_t>{ 1, 2, 3 }));
+    CHECK(QueryText(db.Path(), "PRAGMA journal_mode;") == "wal");
+    CheckReloads(bank, db.Path());
+}
+
+// после загрузки пишутся только изменения: id оставшихся клиентов не перенумеровываются
+void IncrementalSave() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    for (int i = 0; i < 5; ++i) bank.AddClient(Client(("клиент " + std::to_string(i)).c_str(), i + 1, 100 * (i + 1)));
+    core::SaveToDatabase(bank, db.Path());
+
+    BankSystem edited;
+    core::LoadFromDatabase(edited, db.Path());
+    edited.AddClient(Client("новый", 9, 900, true));
+    edited.UpdateClient(0, Client("клиент 0 изменён", 11, 1100));
+    edited.RemoveClient(2);
+    CHECK(edited.GetChanges().added.size() == 1);
+    CHECK(edited.GetChanges().updated.size() == 1);
+    CHECK(edited.GetChanges().removed.size() == 1);
+
+    core::SaveToDatabase(edited, db.Path());
+    CHECK(edited.GetChanges().Empty());
+    CHECK((Ids(edited) == std::vector<int64_t>{ 1, 2, 4, 5, 6 }));
+    CheckReloads(edited, db.Path());
+
+    // без изменений повторное сохранение ничего не пишет
+    core::SaveToDatabase(edited, db.Path());
+    CheckReloads(edited, db.Path());
+
+    // добавленный и сразу удалённый клиент в базу не попадает
+    edited.AddClient(Client("временный", 1, 1));
+    edited.RemoveClient(edited.Count() - 1);
+    CHECK(edited.GetChanges().Empty());
+}
+
+// файл удалили или подменили после синхронизации: запись изменений потеряла бы клиентов,
+// поэтому таблица переписывается целиком
+void SaveAfterFileReplaced() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    for (int i = 0; i < 4; ++i) bank.AddClient(Client(("клиент " + std::to_string(i)).c_str(), 2, 100));
+    core::SaveToDatabase(bank, db.Path());
+
+    std::remove(db.Path().c_str());
+    bank.AddClient(Client("после удаления", 3, 300));
+    core::SaveToDatabase(bank, db.Path());
+    CHECK(bank.Count() == 5);
+    CheckReloads(bank, db.Path());
+
+    // без изменений, но файл подменён другой базой
+    test::TempFile other(".db");
+    BankSystem stranger;
+    stranger.AddClient(Client("чужой", 1, 1));
+    core::SaveToDatabase(stranger, other.Path());
+    std::remove(db.Path().c_str());
+    CHECK(std::rename(other.Path().c_str(), db.Path().c_str()) == 0);
+    CHECK(bank.GetChanges().Empty());
+    core::SaveToDatabase(bank, db.Path());
+    CheckReloads(bank, db.Path());
+}
+
+// удаление по идентификатору переставляет последнего клиента на место удалённого;
+// после записи изменений порядок в базе (ORDER BY id) тот же, что в памяти
+void IncrementalSaveAfterSwapRemove() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    for (int i = 0; i < 6; ++i) bank.AddClient(Client(("клиент " + std::to_string(i)).c_str(), i + 1, 100));
+    core::SaveToDatabase(bank, db.Path());
+
+    // сохранённый на место сохранённого
+    CHECK(bank.RemoveClientById(bank.GetHandle(1)));
+    CHECK(bank.GetClient(1).name == "клиент 5");
+    core::SaveToDatabase(bank, db.Path());
+    CHECK(!bank.GetChanges().reset);
+    CheckReloads(bank, db.Path());
+
+    // новый на место сохранённого и сохранённый на место нового
+    bank.AddClient(Client("новый 1", 7, 700));
+    CHECK(bank.RemoveClientById(bank.GetHandle(0)));
+    bank.AddClient(Client("новый 2", 8, 800));
+    core::ClientHandle moved = bank.GetHandle(2);
+    CHECK(bank.RemoveClientById(bank.GetHandle(0)));
+    CHECK(bank.GetClient(0).name == "новый 2");
+    CHECK(bank.IndexOf(moved) == 2);
+    core::SaveToDatabase(bank, db.Path());
+    CheckReloads(bank, db.Path());
+}
+
+// сортировка меняет порядок: таблица переписывается, id снова идут по порядку строк
+void SaveAfterReset() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    bank.AddClient(Client("Борис", 2, 200));
+    bank.AddClient(Client("Анна", 1, 100));
+    bank.AddClient(Client("Виктор", 3, 300, true));
+    core::SaveToDatabase(bank, db.Path());
+
+    bank.Sort({ { core::SortField::Name, false } });
+    CHECK(bank.GetChanges().reset);
+    core::SaveToDatabase(bank, db.Path());
+    CHECK(bank.GetClient(0).name == "Анна");
+    CHECK((Ids(bank) == std::vector<int64_t>{ 1, 2, 3 }));
+    CheckReloads(bank, db.Path());
+
+    // после очистки и новых клиентов в базе остаются только они
+    bank.Clear();
+    bank.AddClient(Client("Галина", 4, 400));
+    core::SaveToDatabase(bank, db.Path());
+    CheckReloads(bank, db.Path());
+    CHECK(QueryText(db.Path(), "SELECT count(*) FROM Clients;") == "1");
+}
+
+void CheckSummary(const BankSystem& bank, const std::string& path) {
+    core::IncomeSummary memory = bank.Summarize();
+    core::IncomeSummary db = core::SummarizeDatabase(path);
+    CHECK(db.count == memory.count);
+    CHECK(db.vipCount == memory.vipCount);
+    CHECK(db.totalIncome == memory.totalIncome);
+    CHECK(db.vipIncome == memory.vipIncome);
+}
+
+// итоги по SQL совпадают с посчитанными в памяти до последнего знака
+void SummaryMatchesMemory() {
+    test::TempFile db(".db");
+    BankSystem bank;
+    std::mt19937 rng(3);
+    for (int i = 0; i < 5000; ++i) {
+        bank.AddClient(Client("клиент", 1 + static_cast<int>(rng() % 30), static_cast<int>(rng() % 1000000), rng() % 3 == 0));
+    }
+    core::SaveToDatabase(bank, db.Path());
+    CheckSummary(bank, db.Path());
+
+    bank.RemoveClient(10);
+    bank.UpdateClient(0, Client("стал VIP", 12, 34567, true));
+    core::SaveToDatabase(bank, db.Path());
+    CheckSummary(bank, db.Path());
+
+    BankSystem empty;
+    core::SaveToDatabase(empty, db.Path());
+    CheckSummary(empty, db.Path());
+}
+
+// подсчёт только читает: в базе без индекса индекс не появляется.
+// переполнение sum() - ошибка, а не итог по части строк
+void SummaryIsReadOnlyAndReportsErrors() {
+    test::TempFile db(".db");
+    sqlite3* raw = nullptr;
+    CHECK(sqlite3_open(db.Path().c_str(), &raw) == SQLITE_OK);
+    CHECK(sqlite3_exec(raw,
+        "CREATE TABLE Clients (id INTEGER PRIMARY KEY AUTOINCREMENT, is_vip INTEGER NOT NULL, "
+        "name TEXT NOT NULL, rate INTEGER NOT NULL, amount_base INTEGER NOT NULL);"
+        "INSERT INTO Clients (is_vip, name, rate, amount_base) VALUES (0, 'a', 2, 150), (1, 'b', 3, 50);",
+        nullptr, nullptr, nullptr) == SQLITE_OK);
+    sqlite3_close(raw);
+
+    core::IncomeSummary s = core::SummarizeDatabase(db.Path());
+    CHECK(s.count == 2 && s.vipCount == 1);
+    CHECK(s.totalIncome == (2 * 150 + 3 * 1050) / 100.0);
+    CHECK(QueryText(db.Path(), "SELECT count(*) FROM sqlite_master WHERE type = 'index';") == "0");
+
+    CHECK(sqlite3_open(db.Path().c_str(), &raw) == SQLITE_OK);
+    CHECK(sqlite3_exec(raw,
+        "INSERT INTO Clients (is_vip, name, rate, amount_base) VALUES "
+        "(0, 'c', 1, 5000000000000000000), (0, 'd', 1, 5000000000000000000);",
+        nullptr, nullptr, nullptr) == SQLITE_OK);
+    sqlite3_close(raw);
+    bool thrown = false;
+    try {
+        core::SummarizeDatabase(db.Path());
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+} // namespace
+
+int main() {
+    FullSaveAndReload();
+    IncrementalSave();
+    IncrementalSaveAfterSwapRemove();
+    SaveAfterFileReplaced();
+    SaveAfterReset();
+    SummaryMatchesMemory();
+    SummaryIsReadOnlyAndReportsErrors();
+    return 0;
+}
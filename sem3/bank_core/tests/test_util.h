@@ -0,0 +1,40 @@
+// test_util.h
+#pragma once
+// общее для проверок ядра (ctest): без сторонних библиотек, первая ошибка завершает тест с кодом 1
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::fprintf(stderr, "%s:%d: не выполнено %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1);                                                            \
+        }                                                                            \
+    } while (0)
+
+namespace test {
+
+// уникальный путь во временном каталоге; файл и спутники SQLite (-wal, -shm) удаляются в деструкторе
+class TempFile {
+private:
+    std::string path;
+
+public:
+    explicit TempFile(const std::string& suffix) {
+        std::random_device rd;
+        path = (std::filesystem::temp_directory_path() /
+                ("bank_core_" + std::to_string(rd()) + "_" + std::to_string(rd()) + suffix)).string();
+    }
+    ~TempFile() {
+        for (const char* extra : { "", "-wal", "-shm", "-journal" }) std::remove((path + extra).c_str());
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+    const std::string& Path() const { return path; }
+};
+
+} // namespace test
@@ -0,0 +1,42 @@
+// text.cpp
+#include "text.h"
+
+namespace core {
+
+std::string FoldCase(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 'A' && c <= 'Z') {
+            out += static_cast<char>(c + ('a' - 'A'));
+            continue;
+        }
+        if ((c == 0xD0 || c == 0xD1) && i + 1 < s.size()) {
+            unsigned char n = static_cast<unsigned char>(s[i + 1]);
+            unsigned int cp = ((c & 0x1F) << 6) | (n & 0x3F);
+            if (cp >= 0x410 && cp <= 0x42F) cp += 0x20;      // А-Я -> а-я
+            else if (cp >= 0x400 && cp <= 0x40F) cp += 0x50; // Ѐ-Џ (в т.ч. Ё) -> ѐ-џ
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+            ++i;
+            continue;
+        }
+        out += static_cast<char>(c);
+    }
+    return out;
+}
+
+std::string CollationKey(std::string_view s) {
+    std::string key = FoldCase(s);
+    for (size_t i = 0; i + 1 < key.size(); ++i) {
+        if (key[i] == '\xD1' && key[i + 1] == '\x91') { // ё -> е
+            key[i] = '\xD0';
+            key[i + 1] = '\xB5';
+            ++i;
+        }
+    }
+    return key;
+}
+
+} // namespace core
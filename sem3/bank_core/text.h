@@ -0,0 +1,16 @@
+// text.h
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace core {
+
+// приведение UTF-8 строки к нижнему регистру для сравнения без учёта регистра.
+// обрабатываются латиница и кириллица (включая Ё), остальное копируется как есть
+std::string FoldCase(std::string_view s);
+
+// ключ для сортировки имён: FoldCase, плюс ё считается равной е (как в русском алфавитном порядке).
+// ключи сравниваются побайтно
+std::string CollationKey(std::string_view s);
+
+} // namespace core
@@ -0,0 +1,144 @@
+// view_model.cpp
+#include "view_model.h"
+#include <algorithm>
+
+namespace core {
+
+std::string ClientViewModel::FormatCents(int64_t cents, const std::string& separator) {
+    std::string s;
+    if (cents < 0) {
+        s += '-';
+        cents = -cents;
+    }
+    s += std::to_string(cents / 100);
+    s += separator;
+    int frac = static_cast<int>(cents % 100);
+    s += static_cast<char>('0' + frac / 10);
+    s += static_cast<char>('0' + frac % 10);
+    return s;
+}
+
+ClientViewModel::ClientViewModel(BankSystem& bank, int windowSize)
+    : bank(bank), window(static_cast<size_t>(std::max(windowSize, 1))) {
+    Recount();
+    bank.AddObserver(this);
+}
+
+ClientViewModel::~ClientViewModel() {
+    bank.RemoveObserver(this);
+}
+
+void ClientViewModel::Recount() {
+    totalCents = 0;
+    for (const auto& c : bank.GetClients()) totalCents += c.IncomeCents();
+}
+
+void ClientViewModel::ClearWindow() {
+    for (auto& row : window) row.valid = false;
+}
+
+void ClientViewModel::Invalidate(int index) {
+    int offset = index - windowFirst;
+    if (offset >= 0 && offset < static_cast<int>(window.size()))
+        window[offset].valid = false;
+}
+
+void ClientViewModel::Push(RowChange change) {
+    if (change.kind == RowChangeKind::Reset || pending.size() >= maxPending) {
+        pending.clear();
+        pending.push_back({ RowChangeKind::Reset, 0 });
+        return;
+    }
+    if (!pending.empty() && pending.back().kind == RowChangeKind::Reset) return;
+    pending.push_back(change);
+}
+
+std::string ClientViewModel::FormatCell(const ClientRecord& c, int column, const std::string& separator) {
+    switch (column) {
+    case TypeColumn: return c.vip ? "VIP" : "обычный";
+    case NameColumn: return c.name;
+    case RateColumn: return std::to_string(c.rate);
+    case AmountColumn: return std::to_string(c.EffectiveAmount());
+    case IncomeColumn: return FormatCents(c.IncomeCents(), separator);
+    default: return std::string();
+    }
+}
+
+void ClientViewModel::Format(int index, Row& row) const {
+    const ClientRecord& c = bank.GetClient(index);
+    for (int column = 0; column < ColumnCount; ++column) {
+        row.cells[column] = FormatCell(c, column, decimalSeparator);
+    }
+    row.valid = true;
+}
+
+const std::string& ClientViewModel::GetCell(int row, int column) {
+    static const std::string empty;
+    if (row < 0 || row >= RowCount() || column < 0 || column >= ColumnCount) return empty;
+
+    int size = static_cast<int>(window.size());
+    if (row < windowFirst || row >= windowFirst + size) {
+        // окно сдвигается так, чтобы захватить и строки выше (прокрутка вверх)
+        windowFirst = std::max(0, row - size / 4);
+        ClearWindow();
+    }
+    Row& cached = window[row - windowFirst];
+    if (!cached.valid) Format(row, cached);
+    return cached.cells[column];
+}
+
+void ClientViewModel::SetDecimalSeparator(const std::string& separator) {
+    decimalSeparator = separator;
+    ClearWindow();
+}
+
+std::string ClientViewModel::FormatTotalIncome() const {
+    return FormatCents(totalCents, decimalSeparator);
+}
+
+std::vector<RowChange> ClientViewModel::TakeChanges() {
+    std::vector<RowChange> out;
+    out.swap(pending);
+    return out;
+}
+
+void ClientViewModel::OnInserted(int index, ClientHandle) {
+    totalCents += bank.GetClient(index).IncomeCents();
+    // строки после index сдвинулись; добавление в конец кэш не трогает
+    if (index < RowCount() - 1) ClearWindow();
+    Push({ RowChangeKind::Inserted, index });
+}
+
+void ClientViewModel::OnUpdated(int index, ClientHandle, const ClientRecord& before) {
+    totalCents += bank.GetClient(index).IncomeCents() - before.IncomeCents();
+    Invalidate(index);
+    Push({ RowChangeKind::Updated, index });
+}
+
+void ClientViewModel::OnRemoved(int index, ClientHandle, const ClientRecord& removed, int movedFrom) {
+    totalCents -= removed.IncomeCents();
+    if (movedFrom < 0) {
+        ClearWindow();
+        Push({ RowChangeKind::Removed, index });
+        return;
+    }
+    // последняя строка переехала на место удалённой
+    Invalidate(index);
+    Invalidate(movedFrom);
+    Push({ RowChangeKind::Updated, index });
+    Push({ RowChangeKind::Removed, movedFrom });
+}
+
+void ClientViewModel::OnReset() {
+    Recount();
+    ClearWindow();
+    Push({ RowChangeKind::Reset, 0 });
+}
+
+// те же клиенты в другом порядке: итог прежний, перечитать нужно только строки
+void ClientViewModel::OnReordered() {
+    ClearWindow();
+    Push({ RowChangeKind::Reset, 0 });
+}
+
+} // namespace core
@@ -0,0 +1,94 @@
+// view_model.h
+#pragma once
+// модель представления для таблицы клиентов в виртуальном режиме:
+// строки форматируются только когда их просят (видимое окно кэшируется),
+// изменения BankSystem приходят как отдельные события по номеру строки,
+// общий доход пересчитывается за O(1) на каждое изменение
+#include "bank_core.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core {
+
+enum class RowChangeKind {
+    Inserted,
+    Updated,
+    Removed,
+    Reset, // перечитать всё (сортировка, загрузка или слишком много изменений)
+};
+
+struct RowChange {
+    RowChangeKind kind;
+    int index; // для Reset не используется
+};
+
+class ClientViewModel : public BankObserver {
+public:
+    // столбцы как в таблице формы
+    enum Column {
+        TypeColumn,
+        NameColumn,
+        RateColumn,
+        AmountColumn,
+        IncomeColumn,
+        ColumnCount,
+    };
+
+private:
+    struct Row {
+        bool valid = false;
+        std::string cells[ColumnCount];
+    };
+
+    BankSystem& bank;
+    int64_t totalCents = 0;
+    std::string decimalSeparator = ".";
+
+    int windowFirst = 0;
+    std::vector<Row> window; // кэш отформатированных строк [windowFirst, windowFirst + size)
+
+    std::vector<RowChange> pending;
+    static constexpr size_t maxPending = 1024; // дальше проще перечитать всё
+
+    void Recount();
+    void Invalidate(int index);
+    void ClearWindow();
+    void Push(RowChange change);
+    void Format(int index, Row& row) const;
+
+public:
+    // те же тексты для клиентов не из BankSystem (например, страниц PagedClientTable)
+    static std::string FormatCell(const ClientRecord& c, int column, const std::string& separator);
+    // копейки в текст с двумя знаками после разделителя, как ToString("F2")
+    static std::string FormatCents(int64_t cents, const std::string& separator);
+
+    explicit ClientViewModel(BankSystem& bank, int windowSize = 256);
+    ~ClientViewModel() override;
+
+    ClientViewModel(const ClientViewModel&) = delete;
+    ClientViewModel& operator=(const ClientViewModel&) = delete;
+
+    int RowCount() const { return bank.Count(); }
+
+    // текст ячейки; ссылка живёт до следующего изменения или запроса другой строки
+    const std::string& GetCell(int row, int column);
+
+    // разделитель дробной части для дохода (в форме - из текущей культуры)
+    void SetDecimalSeparator(const std::string& separator);
+    const std::string& DecimalSeparator() const { return decimalSeparator; }
+
+    double TotalIncome() const { return totalCents / 100.0; }
+    std::string FormatTotalIncome() const;
+
+    // накопленные с прошлого вызова изменения, по порядку
+    std::vector<RowChange> TakeChanges();
+
+    void OnInserted(int index, ClientHandle h) override;
+    void OnUpdated(int index, ClientHandle h, const ClientRecord& before) override;
+    void OnRemoved(int index, ClientHandle h, const ClientRecord& removed, int movedFrom) override;
+    void OnReset() override;
+    void OnReordered() override;
+};
+
+} // namespace core
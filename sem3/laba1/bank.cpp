@@ -4,8 +4,40 @@
 #include <locale>    
 #include <codecvt> 
 #include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+#include <cerrno>
 using namespace std;
 
+// выплата по процентам в копейках, точно: amount * size * rate / 100 рублей.
+// при вводе все три - int: amount * size < 2^62 влезает в 64 бита, а с rate уже нет,
+// поэтому храним hi * 10^9 + lo и умножаем на rate каждую часть с переносом
+const unsigned long long kopecksBase = 1000000000ULL;
+
+struct kopecks {
+    unsigned long long hi = 0;
+    unsigned long long lo = 0; // < kopecksBase
+};
+
+inline kopecks payment(long long amount, long long size, long long rate) {
+    unsigned long long product = (unsigned long long)amount * (unsigned long long)size;
+    unsigned long long lo = product % kopecksBase * (unsigned long long)rate; // < 10^12
+    kopecks result;
+    result.hi = product / kopecksBase * (unsigned long long)rate + lo / kopecksBase;
+    result.lo = lo % kopecksBase;
+    return result;
+}
+
+// "рубли.копейки", как std::fixed с двумя знаками, но без потери разрядов double
+string formatMoney(kopecks value) {
+    string digits = to_string(value.lo);
+    if (value.hi != 0) digits = to_string(value.hi) + string(9 - digits.size(), '0') + digits;
+    if (digits.size() < 3) digits.insert(0, 3 - digits.size(), '0');
+    digits.insert(digits.size() - 2, 1, '.');
+    return digits;
+}
+
 class Bank {
 private:
     string bankName ="";
@@ -41,9 +73,8 @@ public:
         bankRate = rate;
     }
 
-    float totalPayment() {
-        float a = depositAmount * (depositSize * bankRate / 100);
-        return a;
+    kopecks totalPayment() {
+        return payment(depositAmount, depositSize, bankRate);
     }
 };
 
@@ -73,8 +104,86 @@ string getString(string textnavvode, string errormessage) {
     return value;
 }
 
-int main(){
+// пакетный расчет: файл со строками "число_вкладов размер_вклада ставка"
+// читаем блоками, считаем по столбцам и сразу пишем результат
+
+const size_t batchBlock = 1 << 16;
+
+// цикл без ветвлений по столбцам, формула - та же payment, что и в диалоге.
+// цикл скалярный: 64-битное умножение и деление на 10^9 компилятор в SIMD не переводит
+void computePayments(const long long* amount, const long long* size, const long long* rate, kopecks* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = payment(amount[i], size[i], rate[i]);
+    }
+}
+
+// одно целое в диапазоне [minValue, maxValue]; strtoll на переполнении ставит ERANGE
+bool parseField(const char*& line, long long minValue, long long maxValue, long long& value) {
+    char* end;
+    errno = 0;
+    value = strtoll(line, &end, 10);
+    if (end == line || errno == ERANGE || value < minValue || value > maxValue) return false;
+    line = end;
+    return true;
+}
+
+// те же ограничения, что и при вводе в getInt
+bool parseScenario(const char* line, long long& amount, long long& size, long long& rate) {
+    if (!parseField(line, 1, numeric_limits<int>::max(), amount)) return false;
+    if (!parseField(line, 1, numeric_limits<int>::max(), size)) return false;
+    if (!parseField(line, 1, 1000, rate)) return false;
+    while (*line == ' ' || *line == '\t' || *line == '\r') line++;
+    return *line == '\0';
+}
+
+void flushBlock(vector<long long>& amount, vector<long long>& size, vector<long long>& rate, vector<kopecks>& out, ostream& os) {
+    size_t n = amount.size();
+    out.resize(n);
+    computePayments(amount.data(), size.data(), rate.data(), out.data(), n);
+    for (size_t i = 0; i < n; i++) {
+        os << formatMoney(out[i]) << '\n';
+    }
+    amount.clear(); size.clear(); rate.clear();
+}
+
+// возвращает число строк с ошибками, для них в результат пишется "error"
+size_t runBatch(istream& in, ostream& os) {
+    vector<long long> amount, size, rate;
+    vector<kopecks> out;
+    amount.reserve(batchBlock); size.reserve(batchBlock); rate.reserve(batchBlock);
+
+    size_t bad = 0;
+    string line;
+    while (getline(in, line)) {
+        long long a, s, r;
+        if (parseScenario(line.c_str(), a, s, r)) {
+            amount.push_back(a); size.push_back(s); rate.push_back(r);
+            if (amount.size() == batchBlock) flushBlock(amount, size, rate, out, os);
+        }
+        else {
+            flushBlock(amount, size, rate, out, os); // порядок строк сохраняется
+            os << "error\n";
+            bad++;
+        }
+    }
+    flushBlock(amount, size, rate, out, os);
+    return bad;
+}
+
+int main(int argc, char* argv[]){
     setlocale(0, "Russian");
+    // bank.exe <сценарии> <результат> - пакетный режим
+    if (argc == 3) {
+        ifstream in(argv[1]);
+        ofstream out(argv[2]);
+        if (!in || !out) {
+            cout << "не удалось открыть файлы" << endl;
+            return 1;
+        }
+        size_t bad = runBatch(in, out);
+        cout << "ошибочных строк: " << bad << endl;
+        return 0;
+    }
     Bank Bank1;
     Bank1.setBankName(getString("Введите название банка : ", "Введите корректное значение : "));
     Bank1.setDepositAmount(getInt("Введите количество вкладов : ", "Введите корректное значение : ", 1));
@@ -82,7 +191,7 @@ int main(){
     Bank1.setBankRate(getInt("Введите размер процентной ставки : ", "Введите корректное значение : ", 1, 1000));
     cout << endl;
     cout << "bank name " << Bank1.getBankName() << endl;
-    cout << "Размер общей выплаты по процентам: " << Bank1.totalPayment() << endl;
+    cout << "Размер общей выплаты по процентам: " << formatMoney(Bank1.totalPayment()) << endl;
 }
 
 
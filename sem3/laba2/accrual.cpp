@@ -0,0 +1,190 @@
+// accrual.cpp
+#include "accrual.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+void AccrualSummary::print(std::ostream& out) const {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2);
+    text << "начисление за день " << day << (complete ? "" : " (не завершено)")
+         << (resumed ? ", продолжение" : "") << ":\n";
+    text << "  вкладов с начислением: " << credited << ", уже начислено раньше: " << skipped << "\n";
+    text << "  начислено всего: " << total << "\n";
+    for (int k = 0; k < 3; ++k) {
+        text << "    " << depositKindToString(static_cast<DepositKind>(k + 1)) << ": " << byKind[k] << "\n";
+    }
+    text << "  время: " << std::setprecision(3) << seconds << " с\n";
+    out << text.str();
+}
+
+AccrualJob::AccrualJob(Bank& bank, std::string checkpointFile, size_t threads)
+    : bank(bank), checkpointFile(std::move(checkpointFile)), threads(threads) {
+    if (this->threads == 0) this->threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+uint32_t AccrualJob::today() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::hours>(now).count() / 24);
+}
+
+// контрольная точка - строки "ключ значение"; суммы с полной точностью double.
+// точка другого банка (или старого формата без номера банка) считается отсутствующей
+bool AccrualJob::readCheckpoint(AccrualSummary& s) const {
+    if (checkpointFile.empty()) return false;
+    std::ifstream in(checkpointFile);
+    if (!in) return false;
+    AccrualSummary r;
+    uint64_t bankId = 0;
+    std::string key;
+    int fields = 0;
+    while (in >> key) {
+        if (key == "bank") in >> bankId;
+        else if (key == "day") in >> r.day;
+        else if (key == "complete") in >> r.complete;
+        else if (key == "credited") in >> r.credited;
+        else if (key == "skipped") in >> r.skipped;
+        else if (key == "total") in >> r.total;
+        else if (key == "kinds") in >> r.byKind[0] >> r.byKind[1] >> r.byKind[2];
+        else if (key == "seconds") in >> r.seconds;
+        else return false;
+        if (!in) return false;
+        ++fields;
+    }
+    if (fields != 8 || bankId != bank.instanceId()) return false;
+    s = r;
+    return true;
+}
+
+// во временный файл и переименование, чтобы после сбоя осталась целая прошлая или новая точка
+void AccrualJob::writeCheckpoint(const AccrualSummary& s) const {
+    if (checkpointFile.empty()) return;
+    std::string tmp = checkpointFile + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out << std::setprecision(17)
+            << "bank " << bank.instanceId() << "\nday " << s.day << "\ncomplete " << s.complete << "\ncredited " << s.credited
+            << "\nskipped " << s.skipped << "\ntotal " << s.total
+            << "\nkinds " << s.byKind[0] << ' ' << s.byKind[1] << ' ' << s.byKind[2]
+            << "\nseconds " << s.seconds << "\n";
+        if (!out) throw std::runtime_error("не удалось записать контрольную точку " + tmp);
+    }
+    if (std::rename(tmp.c_str(), checkpointFile.c_str()) == 0) return;
+    // на Windows rename не заменяет существующий файл
+    std::remove(checkpointFile.c_str());
+    if (std::rename(tmp.c_str(), checkpointFile.c_str()) != 0) {
+        throw std::runtime_error("не удалось записать контрольную точку " + checkpointFile);
+    }
+}
+
+namespace {
+
+// итоги одного потока за раунд
+struct Partial {
+    size_t credited{ 0 };
+    size_t skipped{ 0 };
+    double byKind[3]{};
+};
+
+struct ChunkRef {
+    Deposit* first;
+    size_t size;
+};
+
+// при продолжении дня вклады с начислением за day уже есть в credited с контрольной точки
+void accrueChunk(const ChunkRef& c, uint32_t day, bool resumed, const double* rates, Partial& p) {
+    for (size_t i = 0; i < c.size; ++i) {
+        Deposit& d = c.first[i];
+        if (d.getAccruedDay() >= day) {
+            if (!resumed || d.getAccruedDay() != day) ++p.skipped;
+            continue;
+        }
+        int k = static_cast<int>(d.getKind()) - 1;
+        p.byKind[k] += d.accrueDay(day, rates[k]);
+        ++p.credited;
+    }
+}
+
+} // namespace
+
+AccrualSummary AccrualJob::run(uint32_t day, Clock::time_point deadline) {
+    Clock::time_point start = Clock::now();
+    AccrualSummary s;
+    if (readCheckpoint(s) && s.day == day) {
+        if (s.complete) return s;
+        s.resumed = true;
+    }
+    else {
+        s = AccrualSummary{};
+        s.day = day;
+    }
+
+    double rates[3];
+    for (int k = 0; k < 3; ++k) rates[k] = bank.rates().getRate(static_cast<DepositKind>(k + 1));
+
+    size_t chunks = bank.depositChunkCount();
+    bool finished = true;
+    for (size_t from = 0; from < chunks; from += ROUND_CHUNKS) {
+        if (from > 0 && Clock::now() >= deadline) {
+            finished = false;
+            break;
+        }
+        // куски делаются изменяемыми здесь: копирование при записи трогает общую книгу
+        size_t to = std::min(chunks, from + ROUND_CHUNKS);
+        std::vector<ChunkRef> round;
+        round.reserve(to - from);
+        for (size_t c = from; c < to; ++c) {
+            size_t size = 0;
+            Deposit* first = bank.depositChunkForUpdate(c, size);
+            round.push_back(ChunkRef{ first, size });
+        }
+
+        size_t workers = std::min(threads, round.size());
+        std::vector<Partial> partials(workers);
+        std::atomic<size_t> next{ 0 };
+        auto work = [&](Partial& p) {
+            size_t i;
+            while ((i = next.fetch_add(1, std::memory_order_relaxed)) < round.size()) accrueChunk(round[i], day, s.resumed, rates, p);
+        };
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < workers; ++t) pool.emplace_back(work, std::ref(partials[t]));
+        work(partials[0]);
+        for (auto& t : pool) t.join();
+
+        for (const Partial& p : partials) {
+            s.credited += p.credited;
+            s.skipped += p.skipped;
+            for (int k = 0; k < 3; ++k) s.byKind[k] += p.byKind[k];
+        }
+        s.total = s.byKind[0] + s.byKind[1] + s.byKind[2];
+        s.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+        start = Clock::now();
+        writeCheckpoint(s);
+    }
+
+    s.complete = finished;
+    s.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    writeCheckpoint(s);
+    return s;
+}
+
+std::vector<AccrualSummary> AccrualJob::runDue(uint32_t today, Clock::time_point deadline) {
+    AccrualSummary last;
+    uint32_t first = today;
+    if (readCheckpoint(last)) {
+        // незавершённый день продолжается, завершённый - следующий за ним
+        uint32_t next = last.complete ? last.day + 1 : last.day;
+        first = std::max(next, today >= MAX_CATCH_UP - 1 ? today - (MAX_CATCH_UP - 1) : 0u);
+    }
+    std::vector<AccrualSummary> done;
+    for (uint32_t day = first; day <= today; ++day) {
+        done.push_back(run(day, deadline));
+        if (!done.back().complete) break;
+    }
+    return done;
+}
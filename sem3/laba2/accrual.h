@@ -0,0 +1,64 @@
+// accrual.h
+#pragma once
+// ежедневное начисление процентов на вклады по ставкам RateTable (1/365 годовой за день).
+//
+//   AccrualJob job(bank, "accrual.checkpoint");
+//   for (const AccrualSummary& s : job.runDue(AccrualJob::today())) s.print(std::cout);
+//
+// книга вкладов обходится раундами по ROUND_CHUNKS кусков, куски раунда делятся между потоками.
+// после каждого раунда итоги пишутся в файл контрольной точки. повторного начисления не бывает:
+// каждый вклад помнит день последнего начисления (Deposit::accrueDay), поэтому прерванный день
+// (кончилось окно deadline) просто запускается снова - уже начисленные вклады пропускаются
+// (и не считаются в skipped второй раз), а итоги продолжаются с контрольной точки.
+// точка помнит номер банка (Bank::instanceId) и читается только тем же банком: после падения
+// процесса банк в памяти новый и о начислениях не знает - день начисляется заново с нулевых итогов,
+// а не складывается с итогами прошлого процесса
+// вызывать - в потоке, который меняет банк; пока идёт run, банк нельзя трогать из других мест
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "bank.h"
+
+struct AccrualSummary {
+    uint32_t day{ 0 };            // от эпохи Unix
+    bool complete{ false };       // обойдены все вклады
+    bool resumed{ false };        // продолжение дня с контрольной точки
+    size_t credited{ 0 };         // вкладов, получивших проценты
+    size_t skipped{ 0 };          // уже получили проценты за этот день до первого запуска дня
+    double total{ 0.0 };          // начислено всего
+    double byKind[3]{};           // по типам вкладов 1-3
+    double seconds{ 0.0 };        // время всех запусков дня
+
+    void print(std::ostream& out) const;
+};
+
+class AccrualJob {
+public:
+    static constexpr size_t ROUND_CHUNKS = 256;  // кусков книги (по 1024 вклада) между контрольными точками
+    static constexpr uint32_t MAX_CATCH_UP = 31; // runDue начисляет пропущенные дни, но не больше стольких
+
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Bank& bank;
+    std::string checkpointFile;
+    size_t threads;
+
+    bool readCheckpoint(AccrualSummary& s) const;
+    void writeCheckpoint(const AccrualSummary& s) const;
+
+public:
+    // checkpointFile пустой - без контрольных точек; threads 0 - по числу ядер
+    explicit AccrualJob(Bank& bank, std::string checkpointFile = std::string(), size_t threads = 0);
+
+    // день по UTC
+    static uint32_t today();
+
+    // начисление за день; к deadline новые раунды не начинаются и итог возвращается с complete = false
+    AccrualSummary run(uint32_t day, Clock::time_point deadline = Clock::time_point::max());
+
+    // все не начисленные дни до today по контрольной точке (без неё - только today)
+    std::vector<AccrualSummary> runDue(uint32_t today, Clock::time_point deadline = Clock::time_point::max());
+};
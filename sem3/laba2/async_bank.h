@@ -0,0 +1,51 @@
+// async_bank.h
+#pragma once
+// Bank для сопрограмм (C++20, нужна библиотека bank_core_async): co_await bank.topUpDeposit(...).
+// все сопрограммы работают на одном core::Executor, поэтому блокировки не нужны.
+// операции с одним клиентом выполняются сразу, а подсчёт процентов по всем вкладам
+// идёт частями по снимку и между ними уступает поток - тысячи других операций не ждут конца обхода.
+// параметры сопрограмм передаются по значению: задача ленивая и может начаться позже вызова
+#include <string>
+#include "bank.h"
+#include "../bank_core/async.h"
+
+class AsyncBank {
+private:
+    Bank& bank;
+    core::Executor& exec;
+
+public:
+    static constexpr size_t INTEREST_SLICE = 16384; // вкладов за один шаг подсчёта процентов
+
+    AsyncBank(Bank& bank, core::Executor& exec) : bank(bank), exec(exec) {}
+
+    Bank& native() { return bank; }
+
+    core::Task<bool> addClient(std::string name, std::string passport) {
+        co_return bank.addClient(name, passport);
+    }
+
+    core::Task<bool> openDeposit(std::string passport, DepositKind kind, double initial) {
+        co_return bank.openDeposit(passport, kind, initial);
+    }
+
+    core::Task<bool> topUpDeposit(std::string passport, double value) {
+        co_return bank.topUpDeposit(passport, value);
+    }
+
+    // указатель действителен, пока клиент не удалён (Bank клиентов не удаляет, кроме clear())
+    core::Task<const Client*> getClient(std::string passport) {
+        co_return bank.getClient(passport);
+    }
+
+    // сумма на момент вызова: изменения, сделанные, пока идёт подсчёт, в неё не попадают
+    core::Task<double> calcTotalYearInterest() {
+        DepositSnapshot book = bank.snapshot();
+        double total = 0.0;
+        for (size_t from = 0; from < book.depositCount(); from += INTEREST_SLICE) {
+            if (from > 0) co_await exec.Schedule();
+            total += book.calcYearInterestRange(from, from + INTEREST_SLICE);
+        }
+        co_return total;
+    }
+};
@@ -1,220 +1,11 @@
+#include <cstdlib>
 #include <iostream>
 #include <string>
-#include <vector>
-#include <map>
 #include <limits>
 #include <iomanip>
 #include <regex>
-
-//типы вкладов
-enum class DepositKind {
-    FIXED = 1,     // срочный 
-    SAVINGS = 2,   // накопительный
-    LONG_TERM = 3  // долгосрочный
-};
-
-std::string depositKindToString(DepositKind k) {
-    switch (k) {
-    case DepositKind::FIXED:     return "срочный";
-    case DepositKind::SAVINGS:   return "накопительный";
-    case DepositKind::LONG_TERM: return "долгосрочный";
-    default: return "неизвестный";
-    }
-}
-
-class Client {
-private:
-    std::string fullName;
-    std::string passport;   
-    bool hasDepositFlag{ false };
-public:
-    Client() = default;
-    Client(const std::string& name, const std::string& pass)
-        : fullName(name), passport(pass), hasDepositFlag(false) {
-    }
-
-    const std::string& getName() const { return fullName; }
-    const std::string& getPassport() const { return passport; }
-    bool hasDeposit() const { return hasDepositFlag; }
-    void setHasDeposit(bool v) { hasDepositFlag = v; }
-};
-
-// контейнеризируемый классс
-class Deposit {
-private:
-    std::string clientPassport; 
-    DepositKind kind{ DepositKind::FIXED };
-    double amount{ 0.0 };         
-public:
-    Deposit() = default;
-    Deposit(const std::string& passport, DepositKind k, double initial)
-        : clientPassport(passport), kind(k), amount(initial) {
-    }
-
-    const std::string& getClientPassport() const { return clientPassport; }
-    DepositKind getKind() const { return kind; }
-    double getAmount() const { return amount; }
-
-    bool topUp(double value) {
-        if (value <= 0) return false;
-        amount += value;
-        return true;
-    }
-
-    // годовые проценты по ставке
-    double computeYearInterest(double rate) const {
-        if (rate < 0) return 0.0;
-        return amount * rate;
-    }
-};
-
-// таблица ставок - в долях
-class RateTable {
-private:
-    std::map<DepositKind, double> rates; 
-public:
-    RateTable() {
-        rates[DepositKind::FIXED] = 0.08; // 8%
-        rates[DepositKind::SAVINGS] = 0.06; // 6%
-        rates[DepositKind::LONG_TERM] = 0.10; // 10%
-    }
-
-    void setRate(DepositKind k, double r) { rates[k] = r; }
-
-    double getRate(DepositKind k) const {
-        auto it = rates.find(k);
-        return (it != rates.end()) ? it->second : 0.0;
-    }
-
-    void print() const {
-        std::cout << "текущие годовые ставки:\n";
-        std::cout << "  1) " << depositKindToString(DepositKind::FIXED)
-            << " : " << getRate(DepositKind::FIXED) * 100 << "%\n";
-        std::cout << "  2) " << depositKindToString(DepositKind::SAVINGS)
-            << " : " << getRate(DepositKind::SAVINGS) * 100 << "%\n";
-        std::cout << "  3) " << depositKindToString(DepositKind::LONG_TERM)
-            << " : " << getRate(DepositKind::LONG_TERM) * 100 << "%\n";
-    }
-};
-
-// Bank Singleton
-class Bank {
-private:
-    static Bank* instance;
-
-    std::map<std::string, Client> clientsByPassport; 
-    std::vector<Deposit> deposits;                   
-    RateTable rateTable;
-
-    Bank() = default;
-    Bank(const Bank&) = delete;
-    Bank& operator=(const Bank&) = delete;
-
-public:
-    static Bank& getInstance() {
-        if (!instance) instance = new Bank();
-        return *instance;
-    }
-
-    static void destroyInstance() {
-        instance = nullptr;
-    }
-
-    // деструктор
-    ~Bank() {
-        std::cout << "\n[~Bank] банк корректно завершил работу\n";
-    }
-
-    // операции над ставками 
-    RateTable& rates() { return rateTable; }
-    const RateTable& rates() const { return rateTable; }
-
-    // операции с клиентами
-    bool addClient(const std::string& name, const std::string& passport) {
-        if (name.empty() || passport.empty()) return false;
-        if (clientsByPassport.count(passport) > 0) return false; 
-        clientsByPassport.emplace(passport, Client{ name, passport });
-        return true;
-    }
-
-    bool hasClient(const std::string& passport) const {
-        return clientsByPassport.count(passport) > 0;
-    }
-
-    const Client* getClient(const std::string& passport) const {
-        auto it = clientsByPassport.find(passport);
-        return (it != clientsByPassport.end()) ? &it->second : nullptr;
-    }
-
-    // операции со вкладами 
-    bool openDeposit(const std::string& passport, DepositKind kind, double initial) {
-        auto it = clientsByPassport.find(passport);
-        if (it == clientsByPassport.end()) return false;         
-        if (initial <= 0) return false;
-        if (it->second.hasDeposit()) return false;                
-
-        deposits.emplace_back(passport, kind, initial);
-        it->second.setHasDeposit(true);
-        return true;
-    }
-
-    // пополнить вклад 
-    bool topUpDeposit(const std::string& passport, double value) {
-        if (value <= 0) return false;
-        int idx = findDepositIndexByPassport(passport);
-        if (idx < 0) return false;
-        return deposits[idx].topUp(value);
-    }
-
-    // общая сумма процентов по всем вкладам 
-    double calcTotalYearInterest() const {
-        double total = 0.0;
-        for (const auto& d : deposits) {
-            double rate = rateTable.getRate(d.getKind());
-            total += d.computeYearInterest(rate);
-        }
-        return total;
-    }
-
-    void printClients() const {
-        if (clientsByPassport.empty()) {
-            std::cout << "клиентов пока нет.\n";
-            return;
-        }
-        std::cout << "клиенты банка:\n";
-        for (const auto& kv : clientsByPassport) {
-            const auto& c = kv.second;
-            std::cout << " - " << c.getName()
-                << " | паспорт: " << c.getPassport()
-                << " | вклад: " << (c.hasDeposit() ? "есть" : "нет")
-                << "\n";
-        }
-    }
-
-    void printDeposits() const {
-        if (deposits.empty()) {
-            std::cout << "вкладов пока нет.\n";
-            return;
-        }
-        std::cout << "вклады:\n";
-        for (const auto& d : deposits) {
-            std::cout << " - паспорт: " << d.getClientPassport()
-                << " | тип: " << depositKindToString(d.getKind())
-                << " | сумма: " << std::fixed << std::setprecision(2) << d.getAmount()
-                << "\n";
-        }
-    }
-
-private:
-    int findDepositIndexByPassport(const std::string& passport) const {
-        for (size_t i = 0; i < deposits.size(); ++i) {
-            if (deposits[i].getClientPassport() == passport) return static_cast<int>(i);
-        }
-        return -1;
-    }
-};
-
-Bank* Bank::instance = nullptr;
+#include "accrual.h"
+#include "bank.h"
 
 // ВВОД/ПРОВЕРКИ 
 void clearInput() {
@@ -309,6 +100,8 @@ void printMenu() {
     std::cout << "6. показать всех клиентов\n";
     std::cout << "7. показать все вклады\n";
     std::cout << "8. посчитать общую сумму годовых выплат по всем вкладам\n";
+    std::cout << "9. перевести деньги между вкладами\n";
+    std::cout << "10. начислить проценты за сегодня (или продолжить прерванное начисление)\n";
     std::cout << "0. выход\n";
     std::cout << "=============================\n";
 }
@@ -317,12 +110,18 @@ int main() {
     setlocale(LC_ALL, "Russian");
     std::cout << std::fixed << std::setprecision(2);
 
+#ifdef BANK_WITH_METRICS
+    // метрики операций раз в 10 секунд пишутся в BANK_METRICS_FILE (по умолчанию bank_metrics.prom)
+    const char* metricsFile = std::getenv("BANK_METRICS_FILE");
+    metrics::PeriodicDump metricsDump(metricsFile ? metricsFile : "bank_metrics.prom", std::chrono::seconds(10));
+#endif
+
     Bank& bank = Bank::getInstance();
 
     bool running = true;
     while (running) {
         printMenu();
-        int cmd = readIntInRange("команда: ", 0, 8);
+        int cmd = readIntInRange("команда: ", 0, 10);
         switch (cmd) {
         case 1: {
             bank.rates().print();
@@ -387,6 +186,23 @@ int main() {
                 << total << " руб.\n";
             break;
         }
+        case 9: {
+            std::string from = readNonEmptyLine("паспорт отправителя: ");
+            std::string to = readNonEmptyLine("паспорт получателя: ");
+            double value = readPositiveDouble("сумма перевода (> 0): ");
+            std::cout << "перевод: " << transferStatusToString(bank.transfer(from, to, value)) << "\n";
+            break;
+        }
+        case 10: {
+            // ограниченное по времени начисление продолжается следующим вызовом с контрольной точки.
+            // точка привязана к банку в памяти: файл от прошлого запуска программы не используется
+            int limit = readIntInRange("ограничение по времени, с (0 - без ограничения): ", 0, 3600);
+            AccrualJob::Clock::time_point deadline = limit == 0 ? AccrualJob::Clock::time_point::max()
+                : AccrualJob::Clock::now() + std::chrono::seconds(limit);
+            AccrualJob job(bank, "accrual.checkpoint");
+            for (const AccrualSummary& s : job.runDue(AccrualJob::today(), deadline)) s.print(std::cout);
+            break;
+        }
         case 0: {
             running = false;
             break;
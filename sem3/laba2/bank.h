@@ -0,0 +1,496 @@
+// bank.h
+#pragma once
+// классы банка: вклады, ставки и сам банк (синглтон). меню - в bank.cpp, замеры - в bench.cpp
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <iomanip>
+
+#ifdef BANK_WITH_METRICS
+#include "metrics.h"
+#define BANK_METRIC_SCOPE(op) metrics::ScopedTimer bankMetricTimer(metrics::Op::op)
+#else
+#define BANK_METRIC_SCOPE(op) ((void)0)
+#endif
+
+//типы вкладов
+enum class DepositKind {
+    FIXED = 1,     // срочный 
+    SAVINGS = 2,   // накопительный
+    LONG_TERM = 3  // долгосрочный
+};
+
+inline std::string depositKindToString(DepositKind k) {
+    switch (k) {
+    case DepositKind::FIXED:     return "срочный";
+    case DepositKind::SAVINGS:   return "накопительный";
+    case DepositKind::LONG_TERM: return "долгосрочный";
+    default: return "неизвестный";
+    }
+}
+
+class Client {
+private:
+    std::string fullName;
+    std::string passport;   
+    bool hasDepositFlag{ false };
+public:
+    Client() = default;
+    Client(const std::string& name, const std::string& pass)
+        : fullName(name), passport(pass), hasDepositFlag(false) {
+    }
+
+    const std::string& getName() const { return fullName; }
+    const std::string& getPassport() const { return passport; }
+    bool hasDeposit() const { return hasDepositFlag; }
+    void setHasDeposit(bool v) { hasDepositFlag = v; }
+};
+
+// контейнеризируемый классс
+class Deposit {
+private:
+    std::string clientPassport; 
+    DepositKind kind{ DepositKind::FIXED };
+    double amount{ 0.0 };         
+    uint32_t accruedDay{ 0 };     // последний день (от эпохи Unix), за который начислены проценты
+public:
+    Deposit() = default;
+    Deposit(const std::string& passport, DepositKind k, double initial)
+        : clientPassport(passport), kind(k), amount(initial) {
+    }
+
+    const std::string& getClientPassport() const { return clientPassport; }
+    DepositKind getKind() const { return kind; }
+    double getAmount() const { return amount; }
+
+    bool topUp(double value) {
+        if (value <= 0) return false;
+        amount += value;
+        return true;
+    }
+
+    // снять можно не больше, чем лежит на вкладе
+    bool withdraw(double value) {
+        if (value <= 0 || value > amount) return false;
+        amount -= value;
+        return true;
+    }
+
+    uint32_t getAccruedDay() const { return accruedDay; }
+
+    // проценты за день day по годовой ставке (1/365 годовых) прибавляются к сумме;
+    // повторно за тот же или более ранний день ничего не начисляется. возвращает начисленное
+    double accrueDay(uint32_t day, double yearRate) {
+        if (day <= accruedDay) return 0.0;
+        accruedDay = day;
+        if (yearRate <= 0) return 0.0;
+        double interest = amount * yearRate / 365.0;
+        amount += interest;
+        return interest;
+    }
+
+    // годовые проценты по ставке
+    double computeYearInterest(double rate) const {
+        if (rate < 0) return 0.0;
+        return amount * rate;
+    }
+};
+
+// результат перевода между вкладами
+enum class TransferStatus {
+    OK = 0,
+    NOT_FOUND,     // у отправителя или получателя нет вклада
+    SAME_DEPOSIT,  // перевод на тот же вклад
+    BAD_AMOUNT,    // сумма не положительна или не конечна (validTransferAmount)
+    INSUFFICIENT,  // на вкладе отправителя меньше суммы перевода
+};
+
+// проверка суммы перевода, общая для Bank::transfer и пакетных переводов (transfer.h)
+inline bool validTransferAmount(double value) {
+    return value > 0 && std::isfinite(value);
+}
+
+inline std::string transferStatusToString(TransferStatus s) {
+    switch (s) {
+    case TransferStatus::OK: return "выполнен";
+    case TransferStatus::NOT_FOUND: return "вклад не найден";
+    case TransferStatus::SAME_DEPOSIT: return "перевод на тот же вклад";
+    case TransferStatus::BAD_AMOUNT: return "некорректная сумма";
+    case TransferStatus::INSUFFICIENT: return "недостаточно средств";
+    }
+    return "?";
+}
+
+// таблица ставок - в долях
+class RateTable {
+private:
+    std::map<DepositKind, double> rates; 
+public:
+    RateTable() {
+        rates[DepositKind::FIXED] = 0.08; // 8%
+        rates[DepositKind::SAVINGS] = 0.06; // 6%
+        rates[DepositKind::LONG_TERM] = 0.10; // 10%
+    }
+
+    void setRate(DepositKind k, double r) { rates[k] = r; }
+
+    double getRate(DepositKind k) const {
+        auto it = rates.find(k);
+        return (it != rates.end()) ? it->second : 0.0;
+    }
+
+    void print() const {
+        std::cout << "текущие годовые ставки:\n";
+        std::cout << "  1) " << depositKindToString(DepositKind::FIXED)
+            << " : " << getRate(DepositKind::FIXED) * 100 << "%\n";
+        std::cout << "  2) " << depositKindToString(DepositKind::SAVINGS)
+            << " : " << getRate(DepositKind::SAVINGS) * 100 << "%\n";
+        std::cout << "  3) " << depositKindToString(DepositKind::LONG_TERM)
+            << " : " << getRate(DepositKind::LONG_TERM) * 100 << "%\n";
+    }
+};
+
+// снимок книги вкладов и ставок на момент Bank::snapshot(). куски вкладов общие с банком,
+// поэтому снимок берётся за время, пропорциональное числу кусков, а не вкладов
+class DepositSnapshot {
+public:
+    using Chunk = std::vector<Deposit>;
+
+private:
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    size_t count{ 0 };
+    uint64_t version{ 0 };
+    RateTable rateTable;
+
+public:
+    static constexpr size_t CHUNK = 1024;
+
+    DepositSnapshot() = default;
+    DepositSnapshot(std::vector<std::shared_ptr<const Chunk>> chunks, size_t count, uint64_t version, const RateTable& rates)
+        : chunks(std::move(chunks)), count(count), version(version), rateTable(rates) {
+    }
+
+    size_t depositCount() const { return count; }
+    // номер изменения книги вкладов, на котором снят снимок
+    uint64_t getVersion() const { return version; }
+    const RateTable& rates() const { return rateTable; }
+    const Deposit& deposit(size_t i) const { return (*chunks[i / CHUNK])[i % CHUNK]; }
+
+    double calcYearInterestRange(size_t from, size_t to) const {
+        double total = 0.0;
+        to = std::min(to, count);
+        for (size_t i = from; i < to; ++i) {
+            const Deposit& d = deposit(i);
+            total += d.computeYearInterest(rateTable.getRate(d.getKind()));
+        }
+        return total;
+    }
+
+    double calcTotalYearInterest() const { return calcYearInterestRange(0, count); }
+
+    void printDeposits(std::ostream& out) const {
+        if (count == 0) {
+            out << "вкладов пока нет.\n";
+            return;
+        }
+        out << "вклады:\n";
+        for (size_t i = 0; i < count; ++i) {
+            const Deposit& d = deposit(i);
+            out << " - паспорт: " << d.getClientPassport()
+                << " | тип: " << depositKindToString(d.getKind())
+                << " | сумма: " << std::fixed << std::setprecision(2) << d.getAmount()
+                << "\n";
+        }
+    }
+};
+
+// вклады кусками по CHUNK штук (copy-on-write). каждый снимок начинает новую эпоху;
+// кусок, созданный в прошлой эпохе, мог попасть в снимок, поэтому первое изменение в нём
+// копирует кусок, а снимок продолжает видеть старый. счётчик ссылок shared_ptr тут не смотрим:
+// его уменьшение в потоке отчёта не упорядочено с записью, а эпохи живут только в потоке банка.
+// куски освобождаются, когда их не держат ни книга, ни снимки
+class DepositBook {
+private:
+    using Chunk = DepositSnapshot::Chunk;
+    static constexpr size_t CHUNK = DepositSnapshot::CHUNK;
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    std::vector<uint64_t> chunkEpochs; // эпоха, в которой кусок создан или скопирован
+    size_t count{ 0 };
+    uint64_t version{ 0 };
+    mutable uint64_t epoch{ 0 };
+
+    Chunk& writable(size_t chunk) {
+        std::shared_ptr<Chunk>& p = chunks[chunk];
+        if (chunkEpochs[chunk] != epoch) {
+            auto copy = std::make_shared<Chunk>();
+            copy->reserve(CHUNK);
+            copy->assign(p->begin(), p->end());
+            p = std::move(copy);
+            chunkEpochs[chunk] = epoch;
+        }
+        ++version;
+        return *p;
+    }
+
+public:
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const Deposit& operator[](size_t i) const { return (*chunks[i / CHUNK])[i % CHUNK]; }
+    Deposit& at(size_t i) { return writable(i / CHUNK)[i % CHUNK]; }
+
+    void push_back(Deposit d) {
+        if (count % CHUNK == 0) {
+            chunks.push_back(std::make_shared<Chunk>());
+            chunks.back()->reserve(CHUNK);
+            chunkEpochs.push_back(epoch);
+        }
+        writable(count / CHUNK).push_back(std::move(d));
+        ++count;
+    }
+
+    // на место i встаёт последний вклад
+    void swapRemove(size_t i) {
+        size_t last = count - 1;
+        if (i != last) {
+            // копия до at(i): at может заменить кусок, в котором лежит последний вклад
+            Deposit moved = (*this)[last];
+            at(i) = std::move(moved);
+        }
+        writable(last / CHUNK).pop_back();
+        --count;
+        if (count % CHUNK == 0) {
+            chunks.pop_back();
+            chunkEpochs.pop_back();
+        }
+    }
+
+    void clear() {
+        chunks.clear();
+        chunkEpochs.clear();
+        count = 0;
+        ++version;
+    }
+
+    size_t chunkCount() const { return chunks.size(); }
+
+    Deposit* chunkForUpdate(size_t chunk, size_t& size) {
+        Chunk& c = writable(chunk);
+        size = c.size();
+        return c.data();
+    }
+
+    DepositSnapshot snapshot(const RateTable& rates) const {
+        ++epoch;
+        return DepositSnapshot(std::vector<std::shared_ptr<const Chunk>>(chunks.begin(), chunks.end()), count, version, rates);
+    }
+};
+
+// Bank Singleton
+class Bank {
+private:
+    static Bank* instance;
+
+    std::map<std::string, Client> clientsByPassport; 
+    DepositBook deposits;
+    std::unordered_map<std::string, size_t> depositByPassport; // номер вклада в deposits
+    RateTable rateTable;
+    uint64_t id{ newId() };
+
+    Bank() = default;
+    Bank(const Bank&) = delete;
+    Bank& operator=(const Bank&) = delete;
+
+public:
+    static Bank& getInstance() {
+        if (!instance) instance = new Bank();
+        return *instance;
+    }
+
+    static void destroyInstance() {
+        instance = nullptr;
+    }
+
+    // деструктор
+    ~Bank() {
+        std::cout << "\n[~Bank] банк корректно завершил работу\n";
+    }
+
+    // операции над ставками 
+    RateTable& rates() { return rateTable; }
+    const RateTable& rates() const { return rateTable; }
+
+    // операции с клиентами
+    bool addClient(const std::string& name, const std::string& passport) {
+        BANK_METRIC_SCOPE(ADD_CLIENT);
+        if (name.empty() || passport.empty()) return false;
+        if (clientsByPassport.count(passport) > 0) return false; 
+        clientsByPassport.emplace(passport, Client{ name, passport });
+        return true;
+    }
+
+    size_t clientCount() const { return clientsByPassport.size(); }
+    size_t depositCount() const { return deposits.size(); }
+
+    // удалить всех клиентов и вклады, ставки остаются. вклады новые - и номер банка тоже
+    void clear() {
+        clientsByPassport.clear();
+        deposits.clear();
+        depositByPassport.clear();
+        id = newId();
+    }
+
+    // случайный номер этого банка в памяти: вклады помнят начисления (Deposit::accrueDay) только
+    // в нём, поэтому контрольная точка начисления (accrual.h) другого банка или процесса не подходит
+    uint64_t instanceId() const { return id; }
+
+    bool hasClient(const std::string& passport) const {
+        return clientsByPassport.count(passport) > 0;
+    }
+
+    const Client* getClient(const std::string& passport) const {
+        BANK_METRIC_SCOPE(GET_CLIENT);
+        auto it = clientsByPassport.find(passport);
+        return (it != clientsByPassport.end()) ? &it->second : nullptr;
+    }
+
+    // удалить клиента вместе со вкладом (перенос клиента в другой процесс)
+    bool removeClient(const std::string& passport) {
+        auto it = clientsByPassport.find(passport);
+        if (it == clientsByPassport.end()) return false;
+        int idx = findDepositIndexByPassport(passport);
+        if (idx >= 0) {
+            // на место удалённого встаёт последний вклад
+            depositByPassport.erase(passport);
+            deposits.swapRemove(static_cast<size_t>(idx));
+            if (static_cast<size_t>(idx) < deposits.size()) {
+                depositByPassport[deposits[idx].getClientPassport()] = static_cast<size_t>(idx);
+            }
+        }
+        clientsByPassport.erase(it);
+        return true;
+    }
+
+    // клиенты по возрастанию паспорта, начиная со следующего после after;
+    // fn(const Client&) возвращает false, чтобы остановиться
+    template <class F>
+    void forEachClientAfter(const std::string& after, F fn) const {
+        for (auto it = clientsByPassport.upper_bound(after); it != clientsByPassport.end(); ++it) {
+            if (!fn(it->second)) break;
+        }
+    }
+
+    // операции со вкладами 
+    bool openDeposit(const std::string& passport, DepositKind kind, double initial) {
+        BANK_METRIC_SCOPE(OPEN_DEPOSIT);
+        auto it = clientsByPassport.find(passport);
+        if (it == clientsByPassport.end()) return false;         
+        if (initial <= 0) return false;
+        if (it->second.hasDeposit()) return false;                
+
+        depositByPassport.emplace(passport, deposits.size());
+        deposits.push_back(Deposit(passport, kind, initial));
+        it->second.setHasDeposit(true);
+        return true;
+    }
+
+    const Deposit* getDeposit(const std::string& passport) const {
+        int idx = findDepositIndexByPassport(passport);
+        return (idx >= 0) ? &deposits[idx] : nullptr;
+    }
+
+    // пополнить вклад 
+    bool topUpDeposit(const std::string& passport, double value) {
+        BANK_METRIC_SCOPE(TOP_UP);
+        if (value <= 0) return false;
+        int idx = findDepositIndexByPassport(passport);
+        if (idx < 0) return false;
+        return deposits.at(idx).topUp(value);
+    }
+
+    // перевод с вклада клиента from на вклад клиента to: меняются оба вклада или ни один
+    TransferStatus transfer(const std::string& from, const std::string& to, double value) {
+        if (!validTransferAmount(value)) return TransferStatus::BAD_AMOUNT;
+        int src = findDepositIndexByPassport(from);
+        int dst = findDepositIndexByPassport(to);
+        if (src < 0 || dst < 0) return TransferStatus::NOT_FOUND;
+        if (src == dst) return TransferStatus::SAME_DEPOSIT;
+        if (deposits[src].getAmount() < value) return TransferStatus::INSUFFICIENT;
+        deposits.at(src).withdraw(value);
+        deposits.at(dst).topUp(value);
+        return TransferStatus::OK;
+    }
+
+    // для пакетных переводов (transfer.h): номер вклада клиента или -1 и вклад по номеру для изменения.
+    // ссылка действительна, пока вклады не открываются и не удаляются и не берётся снимок
+    int depositIndex(const std::string& passport) const { return findDepositIndexByPassport(passport); }
+    Deposit& depositForUpdate(size_t index) { return deposits.at(index); }
+
+    // вклады книги кусками, подряд в памяти - для изменения на других потоках (начисление, accrual.h).
+    // условия те же, что у depositForUpdate
+    size_t depositChunkCount() const { return deposits.chunkCount(); }
+    Deposit* depositChunkForUpdate(size_t chunk, size_t& size) { return deposits.chunkForUpdate(chunk, size); }
+
+    // общая сумма процентов по всем вкладам 
+    double calcTotalYearInterest() const {
+        BANK_METRIC_SCOPE(CALC_INTEREST);
+        return calcYearInterestRange(0, deposits.size());
+    }
+
+    // проценты по вкладам с номерами [from, to) - для подсчёта частями
+    double calcYearInterestRange(size_t from, size_t to) const {
+        double total = 0.0;
+        to = std::min(to, deposits.size());
+        for (size_t i = from; i < to; ++i) {
+            double rate = rateTable.getRate(deposits[i].getKind());
+            total += deposits[i].computeYearInterest(rate);
+        }
+        return total;
+    }
+
+    void printClients() const {
+        if (clientsByPassport.empty()) {
+            std::cout << "клиентов пока нет.\n";
+            return;
+        }
+        std::cout << "клиенты банка:\n";
+        for (const auto& kv : clientsByPassport) {
+            const auto& c = kv.second;
+            std::cout << " - " << c.getName()
+                << " | паспорт: " << c.getPassport()
+                << " | вклад: " << (c.hasDeposit() ? "есть" : "нет")
+                << "\n";
+        }
+    }
+
+    void printDeposits() const {
+        snapshot().printDeposits(std::cout);
+    }
+
+    // согласованный снимок вкладов и ставок для долгих отчётов. брать - в потоке, который меняет банк;
+    // читать можно из любого потока, пока банк продолжает меняться (снимок этих изменений не видит)
+    DepositSnapshot snapshot() const {
+        return deposits.snapshot(rateTable);
+    }
+
+private:
+    static uint64_t newId() {
+        std::random_device rd;
+        return (uint64_t(rd()) << 32) | rd();
+    }
+
+    int findDepositIndexByPassport(const std::string& passport) const {
+        auto it = depositByPassport.find(passport);
+        return (it != depositByPassport.end()) ? static_cast<int>(it->second) : -1;
+    }
+};
+
+inline Bank* Bank::instance = nullptr;
@@ -0,0 +1,484 @@
+// bench.cpp
+// замеры горячих операций Bank (addClient, openDeposit, topUpDeposit, getClient, calcTotalYearInterest,
+// снимок вкладов и пополнения, пока снимок держат - копирование кусков при записи, переводы по одному
+// и пакетами через TransferExecutor, начисление процентов за день)
+//
+//   bank_bench [--sizes 1000,100000,...] [--time 0.3] [--out result.csv] [--baseline old.csv]
+//
+// на каждый размер и операцию: нс на операцию, операций (или вкладов) в секунду, выделений памяти
+// на операцию и, если ядро разрешает perf_event, такты/инструкции/промахи кэша на операцию.
+// --out пишет то же в CSV ("-" - в stdout вместо таблицы), --baseline сравнивает нс/оп с прошлым CSV.
+// 100M клиентов - это порядка 20 ГБ памяти, по умолчанию размеры до 1M
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "accrual.h"
+#include "bank.h"
+#include "transfer.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ПОДСЧЁТ ВЫДЕЛЕНИЙ
+// замеры однопоточные, поэтому счётчик обычный (потоки TransferExecutor во время замера не выделяют память).
+// заменены все обычные формы new/delete, включая массивы и выровненные (std::align_val_t).
+// память берётся и отдаётся только через countedAlloc/countedFree: если компилятор встроит delete
+// с голым free, он увидит пару new/free и предупредит (-Wmismatched-new-delete)
+static unsigned long long allocations = 0;
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+// выровненный блок: malloc с запасом, исходный указатель хранится прямо перед блоком
+// (aligned_alloc нет в MSVC, а _aligned_malloc - только там)
+static BENCH_NOINLINE void* countedAlloc(std::size_t size, std::size_t align) {
+    ++allocations;
+    if (size == 0) size = 1;
+    if (align <= alignof(std::max_align_t)) {
+        if (void* p = std::malloc(size)) return p;
+        throw std::bad_alloc();
+    }
+    if (size > SIZE_MAX - align - sizeof(void*)) throw std::bad_alloc();
+    void* raw = std::malloc(size + align + sizeof(void*));
+    if (!raw) throw std::bad_alloc();
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+    void* p = reinterpret_cast<void*>((start + align - 1) & ~(uintptr_t(align) - 1));
+    static_cast<void**>(p)[-1] = raw;
+    return p;
+}
+
+static BENCH_NOINLINE void countedFree(void* p, std::size_t align) noexcept {
+    if (!p) return;
+    std::free(align <= alignof(std::max_align_t) ? p : static_cast<void**>(p)[-1]);
+}
+
+static constexpr std::size_t PLAIN = alignof(std::max_align_t);
+
+void* operator new(std::size_t size) { return countedAlloc(size, PLAIN); }
+void* operator new[](std::size_t size) { return countedAlloc(size, PLAIN); }
+void* operator new(std::size_t size, std::align_val_t al) { return countedAlloc(size, std::size_t(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return countedAlloc(size, std::size_t(al)); }
+
+void operator delete(void* p) noexcept { countedFree(p, PLAIN); }
+void operator delete[](void* p) noexcept { countedFree(p, PLAIN); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p, PLAIN); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p, PLAIN); }
+void operator delete(void* p, std::align_val_t al) noexcept { countedFree(p, std::size_t(al)); }
+void operator delete[](void* p, std::align_val_t al) noexcept { countedFree(p, std::size_t(al)); }
+void operator delete(void* p, std::size_t, std::align_val_t al) noexcept { countedFree(p, std::size_t(al)); }
+void operator delete[](void* p, std::size_t, std::align_val_t al) noexcept { countedFree(p, std::size_t(al)); }
+
+// СЧЁТЧИКИ ПРОЦЕССОРА
+class PerfCounters {
+public:
+    enum Counter { CYCLES, INSTRUCTIONS, CACHE_MISSES, COUNT };
+
+private:
+    int fds[COUNT] = { -1, -1, -1 };
+
+public:
+    PerfCounters() {
+#ifdef __linux__
+        const uint64_t configs[COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES
+        };
+        for (int i = 0; i < COUNT; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds) if (fd >= 0) close(fd);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void reset() {
+#ifdef __linux__
+        for (int fd : fds) if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+#endif
+    }
+
+    void enable() {
+#ifdef __linux__
+        for (int fd : fds) if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    void disable() {
+#ifdef __linux__
+        for (int fd : fds) if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    // -1, если счётчик недоступен (не Linux, нет прав, виртуальная машина без PMU)
+    long long read(Counter c) const {
+#ifdef __linux__
+        long long value = 0;
+        if (fds[c] >= 0 && ::read(fds[c], &value, sizeof(value)) == sizeof(value)) return value;
+#endif
+        return -1;
+    }
+};
+
+// ЗАМЕР
+// копит время, выделения и счётчики только между resume() и pause(),
+// чтобы подготовка данных между повторами в замер не попадала
+class Sampler {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    PerfCounters& perf;
+    Clock::time_point started;
+    unsigned long long allocBase = 0;
+
+public:
+    double seconds = 0.0;
+    unsigned long long allocs = 0;
+    size_t ops = 0;
+
+    explicit Sampler(PerfCounters& perf) : perf(perf) { perf.reset(); }
+
+    void resume() {
+        allocBase = allocations;
+        perf.enable();
+        started = Clock::now();
+    }
+
+    void pause() {
+        seconds += elapsed();
+        perf.disable();
+        allocs += allocations - allocBase;
+    }
+
+    // время с последнего resume()
+    double elapsed() const {
+        return std::chrono::duration<double>(Clock::now() - started).count();
+    }
+};
+
+struct Result {
+    std::string name;
+    size_t size = 0;
+    size_t ops = 0;
+    size_t itemsPerOp = 1; // calcTotalYearInterest за одну операцию обходит все вклады
+    double seconds = 0.0;
+    unsigned long long allocs = 0;
+    long long counters[PerfCounters::COUNT] = { -1, -1, -1 };
+
+    double nsPerOp() const { return ops ? seconds * 1e9 / ops : 0.0; }
+    double itemsPerSecond() const { return seconds > 0 ? double(ops) * itemsPerOp / seconds : 0.0; }
+    double allocsPerOp() const { return ops ? double(allocs) / ops : 0.0; }
+    double counterPerOp(int c) const { return counters[c] >= 0 && ops ? double(counters[c]) / ops : -1.0; }
+};
+
+static Result finish(const char* name, size_t size, const Sampler& s, const PerfCounters& perf,
+                     size_t itemsPerOp = 1) {
+    Result r;
+    r.name = name;
+    r.size = size;
+    r.ops = s.ops;
+    r.itemsPerOp = itemsPerOp;
+    r.seconds = s.seconds;
+    r.allocs = s.allocs;
+    for (int c = 0; c < PerfCounters::COUNT; ++c)
+        r.counters[c] = perf.read(static_cast<PerfCounters::Counter>(c));
+    return r;
+}
+
+// не даёт компилятору выбросить результаты операций
+static volatile double sink = 0.0;
+
+// запросы идут по кругу по order, пока не выйдет время; время проверяется раз в step операций
+template <class Op>
+static void runTimed(Sampler& s, const std::vector<uint32_t>& order, double budget, Op op, size_t step = 256) {
+    s.resume();
+    size_t i = 0;
+    do {
+        for (size_t k = 0; k < step; ++k, ++i) op(order[i % order.size()]);
+    } while (s.elapsed() < budget);
+    s.pause();
+    s.ops += i;
+}
+
+static void fillClients(Bank& bank, const std::vector<std::string>& names, const std::vector<std::string>& passports) {
+    bank.clear();
+    for (size_t i = 0; i < passports.size(); ++i) bank.addClient(names[i], passports[i]);
+}
+
+static DepositKind kindOf(size_t i) {
+    return static_cast<DepositKind>(1 + i % 3);
+}
+
+static std::vector<Result> runSize(size_t n, double budget) {
+    std::vector<Result> results;
+    Bank& bank = Bank::getInstance();
+
+    // паспорта в случайном порядке, чтобы вставка в map не шла по возрастанию ключа
+    std::mt19937_64 rng(n);
+    std::vector<std::string> passports(n), names(n);
+    for (size_t i = 0; i < n; ++i) passports[i] = std::to_string(1000000000ull + i);
+    std::shuffle(passports.begin(), passports.end(), rng);
+    for (size_t i = 0; i < n; ++i) names[i] = "client" + std::to_string(i);
+
+    // случайная последовательность запросов (не больше 1M, дальше по кругу)
+    std::vector<uint32_t> order(std::min<size_t>(n, 1u << 20));
+    std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(n - 1));
+    for (auto& x : order) x = pick(rng);
+
+    {
+        PerfCounters perf;
+        Sampler s(perf);
+        do {
+            bank.clear();
+            s.resume();
+            for (size_t i = 0; i < n; ++i) bank.addClient(names[i], passports[i]);
+            s.pause();
+            s.ops += n;
+        } while (s.seconds < budget);
+        results.push_back(finish("addClient", n, s, perf));
+    }
+    {
+        PerfCounters perf;
+        Sampler s(perf);
+        do {
+            fillClients(bank, names, passports);
+            s.resume();
+            for (size_t i = 0; i < n; ++i) bank.openDeposit(passports[i], kindOf(i), 1000.0 + i % 1000);
+            s.pause();
+            s.ops += n;
+        } while (s.seconds < budget);
+        results.push_back(finish("openDeposit", n, s, perf));
+    }
+    {
+        PerfCounters perf;
+        Sampler s(perf);
+        size_t found = 0;
+        runTimed(s, order, budget, [&](uint32_t i) {
+            const Client* c = bank.getClient(passports[i]);
+            found += c != nullptr && c->hasDeposit();
+        });
+        sink = sink + double(found);
+        results.push_back(finish("getClient", n, s, perf));
+    }
+    {
+        PerfCounters perf;
+        Sampler s(perf);
+        size_t done = 0;
+        runTimed(s, order, budget, [&](uint32_t i) { done += bank.topUpDeposit(passports[i], 1.0); });
+        sink = sink + double(done);
+        results.push_back(finish("topUpDeposit", n, s, perf));
+    }
+    {
+        PerfCounters perf;
+        Sampler s(perf);
+        std::vector<uint32_t> once(1, 0);
+        runTimed(s, once, budget, [&](uint32_t) { sink = sink + double(bank.snapshot().depositCount()); }, 1);
+        results.push_back(finish("snapshot", n, s, perf));
+    }
+    {
+        // отчёт берёт новый снимок каждые 4096 пополнений: первая запись в кусок его копирует
+        PerfCounters perf;
+        Sampler s(perf);
+        size_t done = 0;
+        uint32_t step = 0;
+        DepositSnapshot report = bank.snapshot();
+        runTimed(s, order, budget, [&](uint32_t i) {
+            if (++step % 4096 == 0) report = bank.snapshot();
+            done += bank.topUpDeposit(passports[i], 1.0);
+        });
+        sink = sink + double(done);
+        results.push_back(finish("topUpDepositSnapshotted", n, s, perf));
+    }
+    {
+        PerfCounters perf;
+        Sampler s(perf);
+        size_t done = 0;
+        runTimed(s, order, budget, [&](uint32_t i) {
+            done += bank.transfer(passports[i], passports[(i + 1) % n], 1.0) == TransferStatus::OK;
+        });
+        sink = sink + double(done);
+        results.push_back(finish("transfer", n, s, perf));
+    }
+    {
+        // пакет из 64K случайных переводов; пакет готовится вне замера
+        TransferExecutor executor(bank);
+        std::vector<Transfer> batch(std::min<size_t>(order.size(), 1u << 16));
+        for (size_t k = 0; k < batch.size(); ++k) {
+            batch[k] = Transfer{ passports[order[k]], passports[order[(k + 1) % order.size()]], 1.0 };
+        }
+        PerfCounters perf;
+        Sampler s(perf);
+        size_t done = 0;
+        do {
+            s.resume();
+            std::vector<TransferStatus> r = executor.execute(batch);
+            s.pause();
+            done += static_cast<size_t>(std::count(r.begin(), r.end(), TransferStatus::OK));
+            s.ops += batch.size();
+        } while (s.seconds < budget);
+        sink = sink + double(done);
+        results.push_back(finish("transferBatch", n, s, perf));
+    }
+    {
+        // каждый проход - следующий день, иначе вклады пропускались бы как уже начисленные
+        AccrualJob job(bank);
+        uint32_t day = AccrualJob::today();
+        PerfCounters perf;
+        Sampler s(perf);
+        std::vector<uint32_t> once(1, 0);
+        runTimed(s, once, budget, [&](uint32_t) { sink = sink + job.run(day++).total; }, 1);
+        results.push_back(finish("accrueDay", n, s, perf, n));
+    }
+    {
+        PerfCounters perf;
+        Sampler s(perf);
+        std::vector<uint32_t> once(1, 0);
+        runTimed(s, once, budget, [&](uint32_t) { sink = sink + bank.calcTotalYearInterest(); }, 1);
+        results.push_back(finish("calcTotalYearInterest", n, s, perf, n));
+    }
+
+    bank.clear();
+    return results;
+}
+
+// ВЫВОД
+static std::string formatCounter(double v) {
+    if (v < 0) return "";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f", v);
+    return buf;
+}
+
+static void writeCsv(std::ostream& out, const std::vector<Result>& results) {
+    out << "benchmark,size,ops,ns_per_op,items_per_sec,allocs_per_op,cycles_per_op,instructions_per_op,cache_misses_per_op\n";
+    char buf[128];
+    for (const auto& r : results) {
+        std::snprintf(buf, sizeof(buf), "%.2f,%.0f,%.3f", r.nsPerOp(), r.itemsPerSecond(), r.allocsPerOp());
+        out << r.name << ',' << r.size << ',' << r.ops << ',' << buf
+            << ',' << formatCounter(r.counterPerOp(PerfCounters::CYCLES))
+            << ',' << formatCounter(r.counterPerOp(PerfCounters::INSTRUCTIONS))
+            << ',' << formatCounter(r.counterPerOp(PerfCounters::CACHE_MISSES)) << '\n';
+    }
+}
+
+// нс/оп из прошлого CSV по ключу "операция/размер"
+static std::map<std::string, double> readBaseline(const std::string& filename) {
+    std::map<std::string, double> base;
+    std::ifstream in(filename);
+    std::string line;
+    std::getline(in, line); // заголовок
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string name, size, ops, ns;
+        if (std::getline(ss, name, ',') && std::getline(ss, size, ',') &&
+            std::getline(ss, ops, ',') && std::getline(ss, ns, ',')) {
+            base[name + "/" + size] = std::atof(ns.c_str());
+        }
+    }
+    return base;
+}
+
+static void printTable(const std::vector<Result>& results, const std::map<std::string, double>& base) {
+    std::printf("%-24s %10s %12s %14s %10s %10s %10s %10s %9s\n",
+                "операция", "размер", "нс/оп", "элем/с", "выдел/оп", "такты/оп", "инстр/оп", "промахи/оп",
+                base.empty() ? "" : "к базе");
+    for (const auto& r : results) {
+        std::string change;
+        auto it = base.find(r.name + "/" + std::to_string(r.size));
+        if (it != base.end() && it->second > 0) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%+.1f%%", (r.nsPerOp() / it->second - 1.0) * 100.0);
+            change = buf;
+        }
+        std::printf("%-24s %10zu %12.1f %14.0f %10.2f %10s %10s %10s %9s\n",
+                    r.name.c_str(), r.size, r.nsPerOp(), r.itemsPerSecond(), r.allocsPerOp(),
+                    formatCounter(r.counterPerOp(PerfCounters::CYCLES)).c_str(),
+                    formatCounter(r.counterPerOp(PerfCounters::INSTRUCTIONS)).c_str(),
+                    formatCounter(r.counterPerOp(PerfCounters::CACHE_MISSES)).c_str(),
+                    change.c_str());
+    }
+}
+
+static bool parseSizes(const std::string& text, std::vector<size_t>& sizes) {
+    sizes.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        unsigned long long v = std::strtoull(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || v == 0 || v > 0xFFFFFFFFull) return false;
+        sizes.push_back(static_cast<size_t>(v));
+    }
+    return !sizes.empty();
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes = { 1000, 10000, 100000, 1000000 };
+    double budget = 0.3;
+    std::string outFile, baselineFile;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue && parseSizes(argv[i + 1], sizes)) ++i;
+        else if (arg == "--time" && hasValue && (budget = std::atof(argv[i + 1])) > 0) ++i;
+        else if (arg == "--out" && hasValue) outFile = argv[++i];
+        else if (arg == "--baseline" && hasValue) baselineFile = argv[++i];
+        else {
+            std::fprintf(stderr, "использование: %s [--sizes 1000,100000] [--time сек] [--out файл.csv|-] [--baseline старый.csv]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    for (size_t n : sizes) {
+        std::vector<Result> r = runSize(n, budget);
+        results.insert(results.end(), r.begin(), r.end());
+    }
+
+    if (outFile == "-") {
+        writeCsv(std::cout, results);
+        return 0;
+    }
+    printTable(results, baselineFile.empty() ? std::map<std::string, double>() : readBaseline(baselineFile));
+    if (!outFile.empty()) {
+        std::ofstream out(outFile);
+        writeCsv(out, results);
+        if (!out) {
+            std::fprintf(stderr, "не удалось записать %s\n", outFile.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
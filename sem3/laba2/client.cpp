@@ -0,0 +1,204 @@
+// client.cpp
+#include "client.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using protocol::Command;
+
+static std::runtime_error socketError(const char* what) {
+    return std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+}
+
+BankClient BankClient::connectUnix(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) throw std::runtime_error("слишком длинный путь сокета");
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) throw socketError("socket");
+    BankClient c(fd);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) throw socketError("connect");
+    return c;
+}
+
+BankClient BankClient::connectTcp(uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) throw socketError("socket");
+    BankClient c(fd);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) throw socketError("connect");
+    return c;
+}
+
+BankClient::BankClient(BankClient&& other) noexcept
+    : fd(std::exchange(other.fd, -1)), out(std::move(other.out)), in(std::move(other.in)),
+      inPos(other.inPos), pending(std::move(other.pending)) {
+}
+
+BankClient& BankClient::operator=(BankClient&& other) noexcept {
+    if (this != &other) {
+        if (fd >= 0) close(fd);
+        fd = std::exchange(other.fd, -1);
+        out = std::move(other.out);
+        in = std::move(other.in);
+        inPos = other.inPos;
+        pending = std::move(other.pending);
+    }
+    return *this;
+}
+
+BankClient::~BankClient() {
+    if (fd >= 0) close(fd);
+}
+
+void BankClient::addClient(const std::string& name, const std::string& passport) {
+    protocol::FrameWriter(out).u8(uint8_t(Command::ADD_CLIENT)).str(passport).str(name).finish();
+    pending.push_back(Command::ADD_CLIENT);
+}
+
+void BankClient::openDeposit(const std::string& passport, DepositKind kind, double amount) {
+    protocol::FrameWriter(out).u8(uint8_t(Command::OPEN_DEPOSIT)).str(passport).u8(uint8_t(kind)).f64(amount).finish();
+    pending.push_back(Command::OPEN_DEPOSIT);
+}
+
+void BankClient::topUp(const std::string& passport, double value) {
+    protocol::FrameWriter(out).u8(uint8_t(Command::TOP_UP)).str(passport).f64(value).finish();
+    pending.push_back(Command::TOP_UP);
+}
+
+void BankClient::getClient(const std::string& passport) {
+    protocol::FrameWriter(out).u8(uint8_t(Command::GET_CLIENT)).str(passport).finish();
+    pending.push_back(Command::GET_CLIENT);
+}
+
+void BankClient::totalInterest() {
+    protocol::FrameWriter(out).u8(uint8_t(Command::TOTAL_INTEREST)).finish();
+    pending.push_back(Command::TOTAL_INTEREST);
+}
+
+void BankClient::setRate(DepositKind kind, double rate) {
+    protocol::FrameWriter(out).u8(uint8_t(Command::SET_RATE)).u8(uint8_t(kind)).f64(rate).finish();
+    pending.push_back(Command::SET_RATE);
+}
+
+void BankClient::scan(uint32_t partitions, uint32_t keep, const std::string& after, uint16_t limit) {
+    protocol::FrameWriter(out).u8(uint8_t(Command::SCAN)).u32(partitions).u32(keep).str(after).u16(limit).finish();
+    pending.push_back(Command::SCAN);
+}
+
+void BankClient::removeClient(const std::string& passport) {
+    protocol::FrameWriter(out).u8(uint8_t(Command::REMOVE_CLIENT)).str(passport).finish();
+    pending.push_back(Command::REMOVE_CLIENT);
+}
+
+void BankClient::stats() {
+    protocol::FrameWriter(out).u8(uint8_t(Command::STATS)).finish();
+    pending.push_back(Command::STATS);
+}
+
+void BankClient::getRates() {
+    protocol::FrameWriter(out).u8(uint8_t(Command::GET_RATES)).finish();
+    pending.push_back(Command::GET_RATES);
+}
+
+void BankClient::replicaStatus() {
+    protocol::FrameWriter(out).u8(uint8_t(Command::REPLICA_STATUS)).finish();
+    pending.push_back(Command::REPLICA_STATUS);
+}
+
+void BankClient::flush() {
+    size_t sent = 0;
+    while (sent < out.size()) {
+        ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) throw socketError("send");
+        sent += static_cast<size_t>(n);
+    }
+    out.clear();
+}
+
+void BankClient::readMore() {
+    if (inPos > 0) {
+        in.erase(0, inPos);
+        inPos = 0;
+    }
+    size_t old = in.size();
+    in.resize(old + 64 * 1024);
+    ssize_t n;
+    do {
+        n = recv(fd, &in[old], 64 * 1024, 0);
+    } while (n < 0 && errno == EINTR);
+    in.resize(old + (n > 0 ? static_cast<size_t>(n) : 0));
+    if (n == 0) throw std::runtime_error("сервер закрыл соединение");
+    if (n < 0) throw socketError("recv");
+}
+
+BankClient::Response BankClient::next() {
+    if (pending.empty()) throw std::logic_error("нет запросов без ответа");
+    if (!out.empty()) flush();
+
+    long long len;
+    while ((len = protocol::peekFrameLength(in.data() + inPos, in.size() - inPos)) < 0 ||
+           in.size() - inPos < 4 + static_cast<size_t>(len)) {
+        if (len > protocol::MAX_FRAME) throw std::runtime_error("слишком длинный ответ");
+        readMore();
+    }
+
+    Response r;
+    r.command = pending.front();
+    pending.pop_front();
+    protocol::FrameReader body(in.data() + inPos + 4, static_cast<size_t>(len));
+    inPos += 4 + static_cast<size_t>(len);
+    r.status = static_cast<protocol::Status>(body.u8());
+    if (r.ok() && r.command == Command::GET_CLIENT) {
+        r.name = body.str();
+        r.hasDeposit = body.u8() != 0;
+        r.kind = body.u8();
+        r.amount = body.f64();
+    }
+    else if (r.ok() && r.command == Command::TOTAL_INTEREST) {
+        r.value = body.f64();
+    }
+    else if (r.ok() && r.command == Command::SCAN) {
+        r.done = body.u8() != 0;
+        r.cursor = body.str();
+        uint16_t count = body.u16();
+        r.entries.reserve(count);
+        for (uint16_t i = 0; i < count && body.ok(); ++i) {
+            protocol::ClientEntry e;
+            e.passport = body.str();
+            e.name = body.str();
+            e.hasDeposit = body.u8() != 0;
+            e.kind = body.u8();
+            e.amount = body.f64();
+            r.entries.push_back(std::move(e));
+        }
+    }
+    else if (r.ok() && r.command == Command::STATS) {
+        r.clients = body.u64();
+        r.deposits = body.u64();
+    }
+    else if (r.ok() && r.command == Command::GET_RATES) {
+        for (double& rate : r.rates) rate = body.f64();
+    }
+    else if (r.ok() && r.command == Command::REPLICA_STATUS) {
+        r.role = body.u8();
+        r.seq = body.u64();
+        r.lag = body.f64();
+        r.links = body.u32();
+    }
+    if (!body.ok()) throw std::runtime_error("испорченный ответ сервера");
+    return r;
+}
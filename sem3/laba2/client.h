@@ -0,0 +1,81 @@
+// client.h
+#pragma once
+// клиент bank_server (только Linux). запросы копятся в буфере и уходят одной отправкой в flush(),
+// ответы забираются по порядку через next() - так можно держать в полёте сотни запросов:
+//
+//   BankClient c = BankClient::connectUnix("/tmp/bank.sock");
+//   for (auto& p : passports) c.topUp(p, 100.0);
+//   for (size_t i = 0; i < passports.size(); ++i) c.next();
+//
+// сервер перестаёт читать запросы соединения, пока у него не забрано 4 МБ ответов, поэтому
+// между next() лучше держать в полёте не больше нескольких тысяч запросов.
+// ошибки соединения - std::runtime_error
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "bank.h"
+#include "protocol.h"
+
+class BankClient {
+public:
+    struct Response {
+        protocol::Command command{ protocol::Command::GET_CLIENT };
+        protocol::Status status{ protocol::Status::OK };
+        std::string name;       // GET_CLIENT
+        bool hasDeposit{ false }; // GET_CLIENT
+        uint8_t kind{ 0 };      // GET_CLIENT: тип вклада
+        double amount{ 0.0 };   // GET_CLIENT: сумма вклада
+        double value{ 0.0 };    // TOTAL_INTEREST
+        std::vector<protocol::ClientEntry> entries; // SCAN
+        std::string cursor;     // SCAN: передать в следующий scan
+        bool done{ false };     // SCAN: клиентов после курсора не осталось
+        uint64_t clients{ 0 };  // STATS
+        uint64_t deposits{ 0 }; // STATS
+        double rates[3]{};      // GET_RATES, по типам 1-3
+        uint8_t role{ 0 };      // REPLICA_STATUS: 0 - без репликации, 1 - ведущий, 2 - последователь
+        uint64_t seq{ 0 };      // REPLICA_STATUS: последний номер журнала
+        double lag{ 0.0 };      // REPLICA_STATUS: отставание последователя, с
+        uint32_t links{ 0 };    // REPLICA_STATUS: последователей у ведущего или связь с ведущим
+
+        bool ok() const { return status == protocol::Status::OK; }
+    };
+
+private:
+    int fd{ -1 };
+    std::string out;
+    std::string in;
+    size_t inPos{ 0 };
+    std::deque<protocol::Command> pending; // отправленные запросы без ответа, по порядку
+
+    explicit BankClient(int fd) : fd(fd) {}
+    void readMore();
+
+public:
+    static BankClient connectUnix(const std::string& path);
+    static BankClient connectTcp(uint16_t port); // 127.0.0.1
+
+    BankClient(BankClient&& other) noexcept;
+    BankClient& operator=(BankClient&& other) noexcept;
+    BankClient(const BankClient&) = delete;
+    BankClient& operator=(const BankClient&) = delete;
+    ~BankClient();
+
+    void addClient(const std::string& name, const std::string& passport);
+    void openDeposit(const std::string& passport, DepositKind kind, double amount);
+    void topUp(const std::string& passport, double value);
+    void getClient(const std::string& passport);
+    void totalInterest();
+    void setRate(DepositKind kind, double rate);
+    // для переноса клиентов между разделами (router.h)
+    void scan(uint32_t partitions, uint32_t keep, const std::string& after, uint16_t limit);
+    void removeClient(const std::string& passport);
+    void stats();
+    void getRates();
+    void replicaStatus();
+
+    void flush();
+    size_t inFlight() const { return pending.size(); }
+    // ответ на самый старый запрос; неотправленные запросы сначала отправляются
+    Response next();
+};
@@ -0,0 +1,204 @@
+// metrics.cpp
+#include "metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+
+namespace metrics {
+
+namespace {
+
+constexpr int OP_COUNT = static_cast<int>(Op::COUNT);
+
+// буфер одного потока: пишет только владелец (без lock-префикса), snapshot() только читает.
+// атомарные нужны, чтобы чтение из другого потока не было гонкой
+struct ThreadBuffer {
+    std::atomic<uint64_t> count[OP_COUNT];
+    std::atomic<uint64_t> sumNs[OP_COUNT];
+    std::atomic<uint64_t> maxNs[OP_COUNT];
+    std::atomic<uint64_t> buckets[OP_COUNT][BUCKET_COUNT];
+};
+
+void bump(std::atomic<uint64_t>& x, uint64_t by) {
+    x.store(x.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+void addTo(Snapshot& s, const ThreadBuffer& b) {
+    for (int op = 0; op < OP_COUNT; ++op) {
+        Histogram& h = s.ops[op];
+        h.count += b.count[op].load(std::memory_order_relaxed);
+        h.sumNs += b.sumNs[op].load(std::memory_order_relaxed);
+        h.maxNs = std::max(h.maxNs, b.maxNs[op].load(std::memory_order_relaxed));
+        for (int i = 0; i < BUCKET_COUNT; ++i) h.buckets[i] += b.buckets[op][i].load(std::memory_order_relaxed);
+    }
+}
+
+struct Registry {
+    std::mutex m;
+    std::vector<const ThreadBuffer*> live;
+    Snapshot retired; // данные завершившихся потоков
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// буфер регистрируется при первом замере в потоке и сливается в retired при завершении потока
+struct LocalBuffer {
+    ThreadBuffer* buffer;
+
+    LocalBuffer() : buffer(new ThreadBuffer()) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.m);
+        r.live.push_back(buffer);
+    }
+
+    ~LocalBuffer() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.m);
+        addTo(r.retired, *buffer);
+        r.live.erase(std::find(r.live.begin(), r.live.end(), buffer));
+        delete buffer;
+    }
+};
+
+ThreadBuffer& localBuffer() {
+    thread_local LocalBuffer local;
+    return *local.buffer;
+}
+
+} // namespace
+
+const char* opName(Op op) {
+    switch (op) {
+    case Op::ADD_CLIENT:    return "add_client";
+    case Op::OPEN_DEPOSIT:  return "open_deposit";
+    case Op::TOP_UP:        return "top_up";
+    case Op::GET_CLIENT:    return "get_client";
+    case Op::CALC_INTEREST: return "calc_interest";
+    default: return "unknown";
+    }
+}
+
+// корзина 0 - значения 0..31 по одному; дальше группа g >= 1 покрывает [32 << (g-1), 64 << (g-1))
+int bucketOf(uint64_t ns) {
+    ns = std::min<uint64_t>(ns, (uint64_t(1) << (MAX_EXPONENT + 1)) - 1);
+    if (ns < SUB_COUNT) return static_cast<int>(ns);
+    int exponent = 0; // старший бит, двоичным поиском за 6 шагов
+    for (int step = 32; step > 0; step >>= 1)
+        if (ns >> (exponent + step)) exponent += step;
+    int group = exponent - SUB_BITS + 1;
+    int sub = static_cast<int>(ns >> (exponent - SUB_BITS)) - SUB_COUNT;
+    return group * SUB_COUNT + sub;
+}
+
+uint64_t bucketUpper(int bucket) {
+    int group = bucket / SUB_COUNT;
+    uint64_t sub = bucket % SUB_COUNT;
+    if (group == 0) return sub;
+    uint64_t lower = (SUB_COUNT + sub) << (group - 1);
+    return lower + (uint64_t(1) << (group - 1)) - 1;
+}
+
+uint64_t Histogram::percentileNs(double p) const {
+    if (count == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p * count);
+    if (rank >= count) rank = count - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen > rank) return std::min(bucketUpper(i), maxNs);
+    }
+    return maxNs;
+}
+
+void record(Op op, uint64_t ns) {
+    ThreadBuffer& b = localBuffer();
+    int i = static_cast<int>(op);
+    bump(b.count[i], 1);
+    bump(b.sumNs[i], ns);
+    if (ns > b.maxNs[i].load(std::memory_order_relaxed)) b.maxNs[i].store(ns, std::memory_order_relaxed);
+    bump(b.buckets[i][bucketOf(ns)], 1);
+}
+
+Snapshot snapshot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.m);
+    Snapshot s = r.retired;
+    for (const ThreadBuffer* b : r.live) addTo(s, *b);
+    return s;
+}
+
+std::string toPrometheus(const Snapshot& s) {
+    // границы 1-2-5 от 100 нс до 10 с; корзина HDR попадает в le, если целиком не больше его
+    static const double bounds[] = {
+        1e-7, 2e-7, 5e-7, 1e-6, 2e-6, 5e-6, 1e-5, 2e-5, 5e-5, 1e-4, 2e-4, 5e-4,
+        1e-3, 2e-3, 5e-3, 1e-2, 2e-2, 5e-2, 1e-1, 2e-1, 5e-1, 1.0, 2.0, 5.0, 10.0
+    };
+    std::string out =
+        "# HELP bank_operation_duration_seconds Duration of Bank operations.\n"
+        "# TYPE bank_operation_duration_seconds histogram\n";
+    char line[512];
+    for (int op = 0; op < OP_COUNT; ++op) {
+        const Histogram& h = s.ops[op];
+        const char* name = opName(static_cast<Op>(op));
+        uint64_t cumulative = 0;
+        int bucket = 0;
+        for (double le : bounds) {
+            uint64_t limitNs = static_cast<uint64_t>(le * 1e9 + 0.5);
+            while (bucket < BUCKET_COUNT && bucketUpper(bucket) <= limitNs) cumulative += h.buckets[bucket++];
+            std::snprintf(line, sizeof(line), "bank_operation_duration_seconds_bucket{op=\"%s\",le=\"%g\"} %llu\n",
+                          name, le, (unsigned long long)cumulative);
+            out += line;
+        }
+        std::snprintf(line, sizeof(line),
+                      "bank_operation_duration_seconds_bucket{op=\"%s\",le=\"+Inf\"} %llu\n"
+                      "bank_operation_duration_seconds_sum{op=\"%s\"} %.9f\n"
+                      "bank_operation_duration_seconds_count{op=\"%s\"} %llu\n",
+                      name, (unsigned long long)h.count, name, h.sumNs / 1e9, name, (unsigned long long)h.count);
+        out += line;
+    }
+    return out;
+}
+
+bool writePrometheus(const std::string& path) {
+    std::string text = toPrometheus(snapshot());
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out << text;
+        if (!out) return false;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) == 0) return true;
+    // на Windows rename не заменяет существующий файл
+    std::remove(path.c_str());
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+PeriodicDump::PeriodicDump(std::string path, std::chrono::milliseconds interval)
+    : path(std::move(path)), interval(interval) {
+    worker = std::thread(&PeriodicDump::run, this);
+}
+
+PeriodicDump::~PeriodicDump() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+    writePrometheus(path);
+}
+
+void PeriodicDump::run() {
+    std::unique_lock<std::mutex> lock(m);
+    while (!wake.wait_for(lock, interval, [this] { return stopping; })) {
+        lock.unlock();
+        writePrometheus(path);
+        lock.lock();
+    }
+}
+
+} // namespace metrics
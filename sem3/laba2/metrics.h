@@ -0,0 +1,97 @@
+// metrics.h
+#pragma once
+// счётчики и гистограммы задержек операций Bank. собираются только с BANK_WITH_METRICS
+// (cmake -DBANK_WITH_METRICS=ON): без него bank.h этот файл не подключает и замеров в операциях нет.
+// каждый поток пишет в свой буфер без блокировок, snapshot() складывает буферы всех потоков
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace metrics {
+
+enum class Op {
+    ADD_CLIENT,
+    OPEN_DEPOSIT,
+    TOP_UP,
+    GET_CLIENT,
+    CALC_INTEREST,
+    COUNT
+};
+
+const char* opName(Op op);
+
+// корзины как в HdrHistogram: на каждую степень двойки 32 равные корзины,
+// так что погрешность значения не больше 1/32 (~3%). значения до 2^43 нс (~2.4 часа)
+constexpr int SUB_BITS = 5;
+constexpr int SUB_COUNT = 1 << SUB_BITS;
+constexpr int MAX_EXPONENT = 42;
+constexpr int BUCKET_COUNT = (MAX_EXPONENT - SUB_BITS + 2) * SUB_COUNT;
+
+int bucketOf(uint64_t ns);
+uint64_t bucketUpper(int bucket); // наибольшее значение, попадающее в корзину
+
+struct Histogram {
+    uint64_t count{ 0 };
+    uint64_t sumNs{ 0 };
+    uint64_t maxNs{ 0 };
+    std::vector<uint64_t> buckets = std::vector<uint64_t>(BUCKET_COUNT);
+
+    double meanNs() const { return count ? double(sumNs) / count : 0.0; }
+    // p от 0 до 1; возвращает верхнюю границу корзины, но не больше максимума
+    uint64_t percentileNs(double p) const;
+};
+
+struct Snapshot {
+    Histogram ops[static_cast<int>(Op::COUNT)];
+
+    const Histogram& operator[](Op op) const { return ops[static_cast<int>(op)]; }
+};
+
+void record(Op op, uint64_t ns);
+Snapshot snapshot();
+
+// текстовый формат Prometheus: гистограмма bank_operation_duration_seconds с меткой op
+std::string toPrometheus(const Snapshot& s);
+// пишет во временный файл и переименовывает, чтобы читатель не увидел половину
+bool writePrometheus(const std::string& path);
+
+// раз в interval пишет метрики в файл в фоновом потоке, последний раз - при уничтожении
+class PeriodicDump {
+private:
+    std::string path;
+    std::chrono::milliseconds interval;
+    std::mutex m;
+    std::condition_variable wake;
+    bool stopping{ false };
+    std::thread worker;
+
+    void run();
+
+public:
+    PeriodicDump(std::string path, std::chrono::milliseconds interval);
+    ~PeriodicDump();
+    PeriodicDump(const PeriodicDump&) = delete;
+    PeriodicDump& operator=(const PeriodicDump&) = delete;
+};
+
+// замер операции от создания до выхода из области видимости
+class ScopedTimer {
+private:
+    Op op;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(Op op) : op(op), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        record(op, static_cast<uint64_t>(ns.count()));
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+} // namespace metrics
@@ -0,0 +1,20 @@
+// partition.h
+#pragma once
+// разбиение клиентов между процессами bank_server: 64-битный FNV-1a от паспорта,
+// старшие 32 бита делятся на N равных диапазонов, раздел i - i-й диапазон.
+// хеш не зависит от платформы, поэтому роутер и серверы считают разделы одинаково
+#include <cstdint>
+#include <string>
+
+inline uint64_t passportHash(const std::string& passport) {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : passport) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+inline uint32_t partitionOf(const std::string& passport, uint32_t partitions) {
+    return static_cast<uint32_t>(((passportHash(passport) >> 32) * partitions) >> 32);
+}
@@ -0,0 +1,108 @@
+// partition_main.cpp
+// bank_partition: кластер из нескольких процессов bank_server через BankRouter.
+// разделы - список через запятую, каждый - путь Unix-сокета или TCP-порт:
+//
+//   bank_partition /tmp/b0.sock,/tmp/b1.sock fill 100000     клиенты со вкладами
+//   bank_partition /tmp/b0.sock,/tmp/b1.sock stats            клиентов и вкладов в каждом разделе
+//   bank_partition /tmp/b0.sock,/tmp/b1.sock interest         проценты по всем вкладам
+//   bank_partition /tmp/b0.sock,/tmp/b1.sock rate 2 0.08      ставка для всех разделов
+//   bank_partition /tmp/b0.sock,/tmp/b1.sock repartition /tmp/b0.sock,/tmp/b1.sock,/tmp/b2.sock
+//   bank_partition /tmp/b0.sock,/tmp/r0.sock replication      роль, номер журнала и отставание каждого
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "router.h"
+
+static std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t comma = s.find(',', start);
+        if (comma == std::string::npos) comma = s.size();
+        if (comma > start) items.push_back(s.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return items;
+}
+
+static int usage() {
+    std::fprintf(stderr, "использование: bank_partition разделы fill N | stats | interest | rate тип ставка | repartition новые_разделы | replication\n");
+    return 2;
+}
+
+// клиенты fill0..fill(N-1), у каждого вклад; запросы идут конвейером пачками
+static void fill(BankRouter& router, long count) {
+    const long BATCH = 2048;
+    long rejected = 0;
+    for (long from = 0; from < count; from += BATCH) {
+        for (long i = from; i < count && i < from + BATCH; ++i) {
+            std::string passport = "fill" + std::to_string(i);
+            BankClient& c = router.route(passport);
+            c.addClient("Клиент " + std::to_string(i), passport);
+            c.openDeposit(passport, static_cast<DepositKind>(1 + i % 3), 1000.0 + static_cast<double>(i % 1000));
+        }
+        for (size_t p = 0; p < router.partitions(); ++p) {
+            BankClient& c = router.partition(p);
+            while (c.inFlight() > 0) {
+                if (!c.next().ok()) ++rejected;
+            }
+        }
+    }
+    std::printf("добавлено клиентов: %ld, отклонено операций: %ld\n", count, rejected);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+    std::string command = argv[2];
+    try {
+        BankRouter router(splitList(argv[1]));
+        if (command == "fill" && argc == 4) {
+            fill(router, std::atol(argv[3]));
+        }
+        else if (command == "stats" && argc == 3) {
+            for (const auto& s : router.stats()) {
+                std::printf("%-24s клиентов %10llu  вкладов %10llu\n", s.endpoint.c_str(),
+                            static_cast<unsigned long long>(s.clients), static_cast<unsigned long long>(s.deposits));
+            }
+        }
+        else if (command == "replication" && argc == 3) {
+            static const char* roles[] = { "без репликации", "ведущий", "последователь" };
+            for (size_t i = 0; i < router.partitions(); ++i) {
+                BankClient& c = router.partition(i);
+                c.replicaStatus();
+                BankClient::Response r = c.next();
+                if (!r.ok() || r.role > 2) throw std::runtime_error("сервер не сообщил о репликации");
+                std::printf("%-24s %-16s номер %10llu  отставание %.3f с  связей %u\n", router.endpointList()[i].c_str(),
+                            roles[r.role], static_cast<unsigned long long>(r.seq), r.lag, r.links);
+            }
+        }
+        else if (command == "interest" && argc == 3) {
+            std::printf("%.2f\n", router.calcTotalYearInterest());
+        }
+        else if (command == "rate" && argc == 5) {
+            int kind = std::atoi(argv[3]);
+            if (kind < 1 || kind > 3 || !router.setRate(static_cast<DepositKind>(kind), std::atof(argv[4]))) {
+                std::fprintf(stderr, "ставка не принята\n");
+                return 1;
+            }
+        }
+        else if (command == "repartition" && argc == 4) {
+            auto start = std::chrono::steady_clock::now();
+            size_t moved = router.repartition(splitList(argv[3]));
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::printf("перенесено клиентов: %zu за %.2f с\n", moved, seconds);
+        }
+        else {
+            return usage();
+        }
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "ошибка: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+// protocol.h
+#pragma once
+// двоичный протокол bank_server. кадр: uint32 длина тела, затем тело; числа little-endian,
+// строки - uint16 длина + байты UTF-8, суммы и ставки - double.
+//
+// запрос: uint8 команда и поля
+//   ADD_CLIENT     паспорт, имя
+//   OPEN_DEPOSIT   паспорт, uint8 тип (1-3), сумма
+//   TOP_UP         паспорт, сумма
+//   GET_CLIENT     паспорт
+//   TOTAL_INTEREST -
+//   SET_RATE       uint8 тип, ставка в долях
+//   SCAN           uint32 число разделов, uint32 свой раздел (NO_PARTITION - никакой), паспорт-курсор,
+//                  uint16 предел - клиенты после курсора, которые принадлежат другим разделам (partition.h)
+//   REMOVE_CLIENT  паспорт - удалить клиента вместе со вкладом
+//   STATS          -
+//   GET_RATES      -
+//   REPLICA_STATUS -
+// ответ: uint8 статус; при OK для GET_CLIENT ещё имя, uint8 "есть вклад", uint8 тип и сумма вклада
+// (без вклада - нули), для TOTAL_INTEREST - сумма,
+// для SCAN - uint8 "просмотрено до конца", новый курсор, uint16 число записей и записи
+// (паспорт, имя, uint8 есть вклад, uint8 тип, сумма), для STATS - uint64 клиентов и uint64 вкладов,
+// для GET_RATES - ставки типов 1-3, для REPLICA_STATUS - uint8 роль (0 - без репликации, 1 - ведущий,
+// 2 - последователь), uint64 последний номер журнала, double отставание в секундах, uint32 число
+// подключённых последователей (у последователя - 1, если есть связь с ведущим).
+// паспорт и имя - не длиннее MAX_FIELD байт.
+//
+// ответы идут в порядке запросов, поэтому клиент может отправить много запросов подряд (конвейер)
+// и не ждать ответа на каждый
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace protocol {
+
+enum class Command : uint8_t {
+    ADD_CLIENT = 1,
+    OPEN_DEPOSIT = 2,
+    TOP_UP = 3,
+    GET_CLIENT = 4,
+    TOTAL_INTEREST = 5,
+    SET_RATE = 6,
+    SCAN = 7,
+    REMOVE_CLIENT = 8,
+    STATS = 9,
+    GET_RATES = 10,
+    REPLICA_STATUS = 11,
+};
+
+enum class Status : uint8_t {
+    OK = 0,
+    REJECTED = 1,    // операция Bank вернула false (дубликат, нет вклада, неверная сумма)
+    NOT_FOUND = 2,   // GET_CLIENT, REMOVE_CLIENT: нет такого клиента
+    BAD_REQUEST = 3, // неизвестная команда или испорченное тело
+    READ_ONLY = 4,   // изменяющий запрос к последователю (replication.h)
+    UNAVAILABLE = 5, // последователь ещё не загрузил снимок ведущего
+};
+
+constexpr uint32_t MAX_FRAME = 64 * 1024;
+constexpr size_t MAX_FIELD = 256;
+constexpr uint32_t NO_PARTITION = 0xFFFFFFFF;
+
+// клиент в ответе SCAN
+struct ClientEntry {
+    std::string passport;
+    std::string name;
+    bool hasDeposit{ false };
+    uint8_t kind{ 0 };
+    double amount{ 0.0 };
+};
+
+// дописывает кадр в конец буфера; длина проставляется в finish()
+class FrameWriter {
+private:
+    std::string& out;
+    size_t start;
+
+public:
+    explicit FrameWriter(std::string& out) : out(out), start(out.size()) {
+        out.append(4, '\0');
+    }
+
+    FrameWriter& u8(uint8_t v) {
+        out += static_cast<char>(v);
+        return *this;
+    }
+
+    FrameWriter& u16(uint16_t v) {
+        out += static_cast<char>(v & 0xFF);
+        out += static_cast<char>(v >> 8);
+        return *this;
+    }
+
+    FrameWriter& u32(uint32_t v) {
+        for (int i = 0; i < 4; ++i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+        return *this;
+    }
+
+    FrameWriter& u64(uint64_t v) {
+        for (int i = 0; i < 8; ++i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+        return *this;
+    }
+
+    FrameWriter& f64(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        for (int i = 0; i < 8; ++i) out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+        return *this;
+    }
+
+    // длиннее 65535 байт строка обрезается
+    FrameWriter& str(const std::string& s) {
+        uint16_t n = static_cast<uint16_t>(s.size() > 0xFFFF ? 0xFFFF : s.size());
+        u16(n);
+        out.append(s, 0, n);
+        return *this;
+    }
+
+    // готовые байты как есть
+    FrameWriter& raw(const char* data, size_t size) {
+        out.append(data, size);
+        return *this;
+    }
+
+    void finish() {
+        uint32_t n = static_cast<uint32_t>(out.size() - start - 4);
+        for (int i = 0; i < 4; ++i) out[start + i] = static_cast<char>((n >> (8 * i)) & 0xFF);
+    }
+};
+
+// читает поля тела кадра; при выходе за конец ok() становится false, а значения - нулевыми
+class FrameReader {
+private:
+    const unsigned char* p;
+    const unsigned char* end;
+    bool good{ true };
+
+    bool need(size_t n) {
+        if (!good || static_cast<size_t>(end - p) < n) good = false;
+        return good;
+    }
+
+public:
+    FrameReader(const char* data, size_t size)
+        : p(reinterpret_cast<const unsigned char*>(data)), end(p + size) {
+    }
+
+    bool ok() const { return good; }
+    bool atEnd() const { return p == end; }
+
+    uint8_t u8() {
+        return need(1) ? *p++ : 0;
+    }
+
+    uint16_t u16() {
+        if (!need(2)) return 0;
+        uint16_t v = static_cast<uint16_t>(p[0] | (p[1] << 8));
+        p += 2;
+        return v;
+    }
+
+    uint32_t u32() {
+        if (!need(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= uint32_t(p[i]) << (8 * i);
+        p += 4;
+        return v;
+    }
+
+    uint64_t u64() {
+        if (!need(8)) return 0;
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= uint64_t(p[i]) << (8 * i);
+        p += 8;
+        return v;
+    }
+
+    double f64() {
+        if (!need(8)) return 0.0;
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) bits |= uint64_t(p[i]) << (8 * i);
+        p += 8;
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    std::string str() {
+        uint16_t n = u16();
+        if (!need(n)) return std::string();
+        std::string s(reinterpret_cast<const char*>(p), n);
+        p += n;
+        return s;
+    }
+};
+
+// длина тела первого кадра в буфере или -1, если заголовок ещё не пришёл целиком
+inline long long peekFrameLength(const char* data, size_t size) {
+    if (size < 4) return -1;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<long long>(uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24));
+}
+
+} // namespace protocol
@@ -0,0 +1,247 @@
+// replay.cpp
+// проигрывание файла нагрузки на банке laba2 или на ядре bank_core:
+//
+//   bank_replay нагрузка.txt [--engine bank|core] [--rate опер/с] [--out задержки.csv]
+//
+// при --rate операции запускаются по расписанию (i-я - через i/rate секунд от начала), и задержка
+// считается от запланированного момента: если банк не успевает, очередь тоже попадает в задержку.
+// без --rate операции идут подряд, задержка - время самой операции
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bank.h"
+#include "workload.h"
+#include "../bank_core/bank_core.h"
+
+using Clock = std::chrono::steady_clock;
+
+// не даёт компилятору выбросить результаты запросов
+static volatile double sink = 0.0;
+
+// ДВИЖКИ
+class Engine {
+public:
+    virtual ~Engine() = default;
+    virtual void apply(const Operation& op) = 0;
+};
+
+class BankEngine : public Engine {
+private:
+    const Workload& w;
+    Bank& bank;
+
+public:
+    explicit BankEngine(const Workload& w) : w(w), bank(Bank::getInstance()) {
+        bank.clear();
+        bank.rates() = RateTable();
+    }
+
+    void apply(const Operation& op) override {
+        switch (op.type) {
+        case OpType::ADD_CLIENT:
+            bank.addClient(w.names[op.client], w.passports[op.client]);
+            break;
+        case OpType::OPEN_DEPOSIT:
+            bank.openDeposit(w.passports[op.client], op.kind, op.value);
+            break;
+        case OpType::TOP_UP:
+            bank.topUpDeposit(w.passports[op.client], op.value);
+            break;
+        case OpType::LOOKUP: {
+            const Client* c = bank.getClient(w.passports[op.client]);
+            sink = sink + (c != nullptr && c->hasDeposit());
+            break;
+        }
+        case OpType::INTEREST:
+            sink = sink + bank.calcTotalYearInterest();
+            break;
+        case OpType::SET_RATE:
+            bank.rates().setRate(op.kind, op.value);
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+// в ядре клиент - это сразу вклад (имя, ставка в %, сумма): клиент без вклада в ядро не попадает,
+// ставка берётся по типу вклада в момент открытия, смена ставки действует на новые вклады
+class CoreEngine : public Engine {
+private:
+    const Workload& w;
+    core::BankSystem bank;
+    std::vector<core::ClientHandle> handles; // по номеру клиента, 0 - вклада нет
+    RateTable rates;
+
+public:
+    explicit CoreEngine(const Workload& w) : w(w), handles(w.passports.size(), 0) {}
+
+    // целые рубли для ядра; false, если сумма не помещается в int (в том числе NaN)
+    static bool toCoreAmount(double value, int& amount) {
+        double rounded = std::round(value);
+        if (!(rounded >= 0 && rounded <= INT_MAX)) return false;
+        amount = static_cast<int>(rounded);
+        return true;
+    }
+
+    void apply(const Operation& op) override {
+        switch (op.type) {
+        case OpType::OPEN_DEPOSIT: {
+            core::ClientRecord c;
+            if (handles[op.client] != 0 || op.value <= 0 || !toCoreAmount(op.value, c.amount)) break;
+            c.name = w.names[op.client];
+            c.rate = static_cast<int>(std::lround(rates.getRate(op.kind) * 100));
+            c.vip = false;
+            handles[op.client] = bank.AddClient(c);
+            break;
+        }
+        case OpType::TOP_UP: {
+            int index = bank.IndexOf(handles[op.client]);
+            int value = 0;
+            if (index < 0 || op.value <= 0 || !toCoreAmount(op.value, value)) break;
+            core::ClientRecord c = bank.GetClient(index);
+            // горячий вклад за долгое проигрывание упирается в int: пополнение сверх него пропускается
+            if (c.amount > INT_MAX - value) break;
+            c.amount += value;
+            bank.UpdateClientById(handles[op.client], c);
+            break;
+        }
+        case OpType::LOOKUP: {
+            int index = bank.IndexOf(handles[op.client]);
+            sink = sink + (index >= 0 ? bank.GetClient(index).amount : 0);
+            break;
+        }
+        case OpType::INTEREST:
+            sink = sink + bank.CalculateTotalIncome();
+            break;
+        case OpType::SET_RATE:
+            rates.setRate(op.kind, op.value);
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+// ПРОИГРЫВАНИЕ
+struct LatencyStats {
+    std::vector<uint64_t> ns[static_cast<int>(OpType::COUNT)];
+};
+
+static void replay(const Workload& w, Engine& engine, double rate, LatencyStats& stats, double& seconds) {
+    for (auto& v : stats.ns) v.reserve(w.ops.size() / 4);
+
+    Clock::time_point start = Clock::now();
+    double interval = rate > 0 ? 1e9 / rate : 0.0;
+    for (size_t i = 0; i < w.ops.size(); ++i) {
+        Clock::time_point begin = Clock::now();
+        if (rate > 0) {
+            Clock::time_point planned = start + std::chrono::nanoseconds(static_cast<long long>(i * interval));
+            // далеко до срока - спим, последние 100 мкс ждём активно, чтобы не проспать
+            if (planned - begin > std::chrono::microseconds(200))
+                std::this_thread::sleep_for(planned - begin - std::chrono::microseconds(100));
+            while (Clock::now() < planned) {}
+            begin = planned;
+        }
+        engine.apply(w.ops[i]);
+        Clock::time_point end = Clock::now();
+        stats.ns[static_cast<int>(w.ops[i].type)].push_back(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+    }
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// p - доля (0.99); сортирует v
+static uint64_t percentile(std::vector<uint64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = std::min(v.size() - 1, static_cast<size_t>(std::ceil(p * v.size())) - (p > 0 ? 1 : 0));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void report(const std::string& engineName, LatencyStats& stats, size_t total, double seconds,
+                   const std::string& outFile) {
+    const double ps[] = { 0.5, 0.9, 0.99, 0.999, 1.0 };
+    std::vector<std::string> rows;
+    std::printf("%-10s %10s %10s %10s %10s %10s %12s\n", "операция", "число", "p50 нс", "p90 нс", "p99 нс", "p99.9 нс", "max нс");
+    for (int t = 0; t < static_cast<int>(OpType::COUNT); ++t) {
+        auto& v = stats.ns[t];
+        if (v.empty()) continue;
+        uint64_t q[5];
+        for (int k = 0; k < 5; ++k) q[k] = percentile(v, ps[k]);
+        const char* name = opTypeToString(static_cast<OpType>(t));
+        std::printf("%-10s %10zu %10llu %10llu %10llu %10llu %12llu\n", name, v.size(),
+                    (unsigned long long)q[0], (unsigned long long)q[1], (unsigned long long)q[2],
+                    (unsigned long long)q[3], (unsigned long long)q[4]);
+        char buf[256];
+        std::snprintf(buf, sizeof(buf), "%s,%s,%zu,%llu,%llu,%llu,%llu,%llu", engineName.c_str(), name, v.size(),
+                      (unsigned long long)q[0], (unsigned long long)q[1], (unsigned long long)q[2],
+                      (unsigned long long)q[3], (unsigned long long)q[4]);
+        rows.push_back(buf);
+    }
+    std::printf("всего %zu операций за %.3f с (%.0f опер/с)\n", total, seconds, seconds > 0 ? total / seconds : 0.0);
+
+    if (outFile.empty()) return;
+    std::ofstream out(outFile);
+    out << "engine,operation,count,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n";
+    for (const auto& r : rows) out << r << '\n';
+    if (!out) std::fprintf(stderr, "не удалось записать %s\n", outFile.c_str());
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "использование: %s нагрузка.txt [--engine bank|core] [--rate опер/с] [--out файл.csv]\n", argv[0]);
+        return 1;
+    }
+    std::string inFile = argv[1], engineName = "bank", outFile;
+    double rate = 0.0;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--engine" && hasValue) engineName = argv[++i];
+        else if (arg == "--rate" && hasValue) rate = std::atof(argv[++i]);
+        else if (arg == "--out" && hasValue) outFile = argv[++i];
+        else {
+            std::fprintf(stderr, "неизвестный параметр %s\n", arg.c_str());
+            return 1;
+        }
+    }
+    if (engineName != "bank" && engineName != "core") {
+        std::fprintf(stderr, "движок: bank или core\n");
+        return 1;
+    }
+
+    Workload w;
+    try {
+        std::ifstream in(inFile);
+        if (!in) throw std::runtime_error("не удалось открыть " + inFile);
+        w = readWorkload(in);
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    LatencyStats stats;
+    double seconds = 0.0;
+    if (engineName == "bank") {
+        BankEngine engine(w);
+        replay(w, engine, rate, stats, seconds);
+        Bank::getInstance().clear();
+    }
+    else {
+        CoreEngine engine(w);
+        replay(w, engine, rate, stats, seconds);
+    }
+    report(engineName, stats, w.ops.size(), seconds, outFile);
+    return 0;
+}
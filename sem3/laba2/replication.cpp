@@ -0,0 +1,182 @@
+// replication.cpp
+#include "replication.h"
+#include <limits>
+#include <random>
+
+namespace replication {
+
+using protocol::Command;
+
+bool isWrite(Command command) {
+    switch (command) {
+    case Command::ADD_CLIENT:
+    case Command::OPEN_DEPOSIT:
+    case Command::TOP_UP:
+    case Command::SET_RATE:
+    case Command::REMOVE_CLIENT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint64_t wallClockNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+static std::string encodeEntry(uint64_t seq, uint64_t timeNs, const char* body, size_t size) {
+    std::string frame;
+    protocol::FrameWriter(frame).u8(uint8_t(Message::ENTRY)).u64(seq).u64(timeNs).raw(body, size).finish();
+    return frame;
+}
+
+Log::Log(size_t maxBytes) : maxBytes(maxBytes) {
+    std::random_device rd;
+    do {
+        epoch = (uint64_t(rd()) << 32) | rd();
+    } while (epoch == 0);
+}
+
+const std::string& Log::append(const char* body, size_t size) {
+    tail.push_back(encodeEntry(++seq, wallClockNs(), body, size));
+    tailBytes += tail.back().size();
+    while (tailBytes > maxBytes && tail.size() > 1) {
+        tailBytes -= tail.front().size();
+        tail.pop_front();
+    }
+    return tail.back();
+}
+
+bool Log::canCatchUp(uint64_t followerEpoch, uint64_t applied) const {
+    uint64_t firstKept = seq - tail.size() + 1;
+    return followerEpoch == epoch && applied <= seq && applied + 1 >= firstKept;
+}
+
+void Log::catchUp(uint64_t applied, std::string& out) const {
+    uint64_t firstKept = seq - tail.size() + 1;
+    for (uint64_t s = applied + 1; s <= seq; ++s) out += tail[s - firstKept];
+    heartbeat(out);
+}
+
+void Log::heartbeat(std::string& out) const {
+    protocol::FrameWriter(out).u8(uint8_t(Message::HEARTBEAT)).u64(seq).u64(wallClockNs()).finish();
+}
+
+// снимок - запросы, из которых пустой банк соберётся в состояние на номере seq. клиенты и вклады
+// читаются уже после seq, пока ведущий меняет банк, поэтому:
+//  - вклад из снимка идёт вместе со своим клиентом (ADD_CLIENT, OPEN_DEPOSIT): книга последователя
+//    получает те же вклады в том же порядке. если клиента с тех пор удалили, имя - его паспорт:
+//    удаление придёт следом записью журнала;
+//  - затем ADD_CLIENT для всех живых клиентов и для удалённых за время снимка, до которых не дошёл
+//    курсор (removing): иначе вклад, открытый и удалённый записями журнала, у ведущего переставил бы
+//    последний вклад книги, а у последователя - нет. уже добавленных последователь отклонит, лишние
+//    клиенты без вкладов только заставят его отклонить их ADD_CLIENT из журнала
+SnapshotStream::SnapshotStream(const Bank& bank, uint64_t epoch, uint64_t seq)
+    : deposits(bank.snapshot()), epoch(epoch), seq(seq) {
+}
+
+bool SnapshotStream::writeSlice(const Bank& bank, size_t maxOps, std::string& out) {
+    auto op = [&out](Command command) {
+        protocol::FrameWriter frame(out);
+        frame.u8(uint8_t(Message::SNAPSHOT_OP)).u8(uint8_t(command));
+        return frame;
+    };
+    if (!begun) {
+        begun = true;
+        protocol::FrameWriter(out).u8(uint8_t(Message::SNAPSHOT_BEGIN)).u64(epoch).finish();
+        for (int k = 1; k <= 3; ++k) {
+            op(Command::SET_RATE).u8(uint8_t(k)).f64(deposits.rates().getRate(static_cast<DepositKind>(k))).finish();
+        }
+    }
+
+    size_t ops = 0;
+    for (; nextDeposit < deposits.depositCount() && ops < maxOps; ++nextDeposit, ops += 2) {
+        const Deposit& d = deposits.deposit(nextDeposit);
+        const std::string& passport = d.getClientPassport();
+        const Client* c = bank.getClient(passport);
+        op(Command::ADD_CLIENT).str(passport).str(c ? c->getName() : passport).finish();
+        op(Command::OPEN_DEPOSIT).str(passport).u8(uint8_t(d.getKind())).f64(d.getAmount()).finish();
+    }
+    if (ops >= maxOps) return false;
+
+    if (!liveDone) {
+        liveDone = true;
+        bank.forEachClientAfter(cursor, [&](const Client& c) {
+            if (ops >= maxOps) {
+                liveDone = false;
+                return false;
+            }
+            cursor = c.getPassport();
+            op(Command::ADD_CLIENT).str(c.getPassport()).str(c.getName()).finish();
+            ++ops;
+            return true;
+        });
+        if (!liveDone) return false;
+    }
+    for (; nextRemoved < removed.size() && ops < maxOps; ++nextRemoved, ++ops) {
+        op(Command::ADD_CLIENT).str(removed[nextRemoved].first).str(removed[nextRemoved].second).finish();
+    }
+    if (nextRemoved < removed.size()) return false;
+
+    protocol::FrameWriter(out).u8(uint8_t(Message::SNAPSHOT_END)).u64(seq).u64(wallClockNs()).finish();
+    return true;
+}
+
+void SnapshotStream::removing(const Client& c) {
+    if (!liveDone && c.getPassport() > cursor) removed.emplace_back(c.getPassport(), c.getName());
+}
+
+void Follower::hello(std::string& out) const {
+    protocol::FrameWriter(out).u8(uint8_t(Message::HELLO)).u64(epoch).u64(applied).finish();
+}
+
+bool Follower::apply(Bank& bank, const char* body, size_t size, std::string_view& request) {
+    request = std::string_view();
+    protocol::FrameReader in(body, size);
+    switch (static_cast<Message>(in.u8())) {
+    case Message::SNAPSHOT_BEGIN:
+        epoch = in.u64();
+        if (!in.ok() || !in.atEnd()) return false;
+        loadingSnapshot = true;
+        bank.clear();
+        return true;
+    case Message::SNAPSHOT_OP:
+        if (!loadingSnapshot || size < 2) return false;
+        request = std::string_view(body + 1, size - 1);
+        return true;
+    case Message::SNAPSHOT_END:
+        applied = in.u64();
+        primaryTimeNs = in.u64();
+        if (!in.ok() || !in.atEnd() || !loadingSnapshot) return false;
+        loadingSnapshot = false;
+        return true;
+    case Message::ENTRY: {
+        uint64_t seq = in.u64();
+        uint64_t timeNs = in.u64();
+        // записи идут строго подряд; пропуск значит, что поток испорчен
+        if (!in.ok() || loadingSnapshot || epoch == 0 || seq != applied + 1 || size <= 17) return false;
+        applied = seq;
+        primaryTimeNs = timeNs;
+        request = std::string_view(body + 17, size - 17);
+        return true;
+    }
+    case Message::HEARTBEAT: {
+        uint64_t seq = in.u64();
+        uint64_t timeNs = in.u64();
+        if (!in.ok() || !in.atEnd() || loadingSnapshot || seq != applied) return false;
+        primaryTimeNs = timeNs;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+double Follower::lagSeconds() const {
+    if (!ready()) return std::numeric_limits<double>::infinity();
+    uint64_t now = wallClockNs();
+    return now > primaryTimeNs ? static_cast<double>(now - primaryTimeNs) / 1e9 : 0.0;
+}
+
+} // namespace replication
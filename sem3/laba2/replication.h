@@ -0,0 +1,124 @@
+// replication.h
+#pragma once
+// репликация bank_server: ведущий нумерует успешные изменяющие запросы (ADD_CLIENT, OPEN_DEPOSIT,
+// TOP_UP, SET_RATE, REMOVE_CLIENT) и рассылает их тела последователям, те выполняют их по порядку
+// на своём Bank и отвечают только на чтение. Bank детерминирован, поэтому состояние совпадает.
+//
+// сообщения - кадры protocol.h, первый байт - тип:
+//   HELLO           последователь -> ведущий: uint64 эпоха ведущего, uint64 последний применённый номер
+//   SNAPSHOT_BEGIN  uint64 эпоха; дальше снимок банка, последователь очищает свой
+//   SNAPSHOT_OP     тело запроса - часть снимка (ставки, клиенты, вклады с суммами на момент снимка)
+//   SNAPSHOT_END    uint64 номер, на котором снят снимок, uint64 время ведущего (нс от эпохи Unix)
+//   ENTRY           uint64 номер, uint64 время ведущего, тело запроса
+//   HEARTBEAT       uint64 последний номер, uint64 время ведущего - раз в HEARTBEAT_INTERVAL
+//
+// эпоха - случайное число при запуске ведущего: журнал хранится только в памяти, после перезапуска
+// ведущего номера начинаются заново и последователь получает снимок. если последователь отстал
+// больше, чем хранит хвост журнала, - тоже снимок, иначе только недостающие записи.
+// снимок уходит частями между запросами клиентов (SnapshotStream), записи журнала за это время
+// последователь получает после SNAPSHOT_END из хвоста
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "bank.h"
+#include "protocol.h"
+
+namespace replication {
+
+enum class Message : uint8_t {
+    HELLO = 1,
+    SNAPSHOT_BEGIN = 2,
+    SNAPSHOT_OP = 3,
+    SNAPSHOT_END = 4,
+    ENTRY = 5,
+    HEARTBEAT = 6,
+};
+
+constexpr auto HEARTBEAT_INTERVAL = std::chrono::milliseconds(100);
+
+// изменяет ли запрос банк (такие попадают в журнал, а последователь их не принимает)
+bool isWrite(protocol::Command command);
+
+// время для сообщений: наносекунды системных часов, общие для процессов одной машины
+uint64_t wallClockNs();
+
+// журнал ведущего: номер последней записи и хвост готовых кадров ENTRY не больше maxBytes
+class Log {
+private:
+    uint64_t epoch;
+    uint64_t seq{ 0 };
+    std::deque<std::string> tail;
+    size_t tailBytes{ 0 };
+    size_t maxBytes;
+
+public:
+    explicit Log(size_t maxBytes = 64 * 1024 * 1024);
+
+    uint64_t epochId() const { return epoch; }
+    uint64_t lastSeq() const { return seq; }
+
+    // новая запись для выполненного запроса; возвращает её кадр для рассылки
+    const std::string& append(const char* body, size_t size);
+
+    // последователя с эпохой followerEpoch, применившего applied, можно догнать хвостом (иначе - снимок)
+    bool canCatchUp(uint64_t followerEpoch, uint64_t applied) const;
+    // недостающие записи после applied и пульс; только если canCatchUp
+    void catchUp(uint64_t applied, std::string& out) const;
+    void heartbeat(std::string& out) const;
+};
+
+// снимок банка для одного последователя, частями: writeSlice на каждом проходе цикла событий,
+// так что ведущий между частями отвечает клиентам. вклады - из Bank::snapshot() на номере seq
+// в порядке книги ведущего (от порядка зависят суммы процентов с плавающей точкой), клиенты без
+// вкладов - из живого банка по курсору паспорта; записи журнала после seq сводят разницу (replication.cpp)
+class SnapshotStream {
+private:
+    DepositSnapshot deposits;
+    uint64_t epoch;
+    uint64_t seq;
+    bool begun{ false };
+    size_t nextDeposit{ 0 };
+    std::string cursor;
+    bool liveDone{ false };
+    std::vector<std::pair<std::string, std::string>> removed; // паспорт и имя
+    size_t nextRemoved{ 0 };
+
+public:
+    SnapshotStream(const Bank& bank, uint64_t epoch, uint64_t seq);
+
+    uint64_t snapshotSeq() const { return seq; }
+
+    // клиента удаляют, пока снимок отправляется: если курсор до него ещё не дошёл, он уйдёт в конце снимка
+    void removing(const Client& c);
+
+    // дописывает в out не больше maxOps запросов снимка; true - снимок закончен (записан SNAPSHOT_END)
+    bool writeSlice(const Bank& bank, size_t maxOps, std::string& out);
+};
+
+// состояние последователя
+class Follower {
+private:
+    uint64_t epoch{ 0 };
+    uint64_t applied{ 0 };
+    uint64_t primaryTimeNs{ 0 };  // время ведущего в последнем применённом сообщении
+    bool loadingSnapshot{ false };
+
+public:
+    // HELLO для нового соединения с ведущим
+    void hello(std::string& out) const;
+
+    // учитывает сообщение ведущего; в request - тело запроса, которое надо выполнить на bank
+    // (пусто, если нечего). false - сообщение испорчено или пришло не по порядку
+    bool apply(Bank& bank, const char* body, size_t size, std::string_view& request);
+
+    bool ready() const { return !loadingSnapshot && epoch != 0; }
+    uint64_t appliedSeq() const { return applied; }
+    // данные последователя не старше стольких секунд (пока не получен снимок - бесконечность)
+    double lagSeconds() const;
+};
+
+} // namespace replication
@@ -0,0 +1,207 @@
+// router.cpp
+#include "router.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "partition.h"
+
+using protocol::Command;
+using protocol::Status;
+
+BankClient BankRouter::connect(const std::string& endpoint) {
+    bool port = !endpoint.empty() && endpoint.size() <= 5 &&
+        std::all_of(endpoint.begin(), endpoint.end(), [](char c) { return c >= '0' && c <= '9'; });
+    if (port && std::stol(endpoint) <= 65535) return BankClient::connectTcp(static_cast<uint16_t>(std::stol(endpoint)));
+    return BankClient::connectUnix(endpoint);
+}
+
+BankRouter::BankRouter(const std::vector<std::string>& endpoints) : endpoints(endpoints) {
+    if (endpoints.empty()) throw std::invalid_argument("нет ни одного раздела");
+    parts.reserve(endpoints.size());
+    for (const auto& e : endpoints) parts.push_back(connect(e));
+}
+
+BankClient::Response BankRouter::call(BankClient& c) {
+    BankClient::Response r = c.next();
+    if (r.status == Status::BAD_REQUEST) throw std::runtime_error("сервер отклонил запрос как испорченный");
+    return r;
+}
+
+BankClient& BankRouter::route(const std::string& passport) {
+    return parts[partitionOf(passport, static_cast<uint32_t>(parts.size()))];
+}
+
+bool BankRouter::addClient(const std::string& name, const std::string& passport) {
+    BankClient& c = route(passport);
+    c.addClient(name, passport);
+    return call(c).ok();
+}
+
+bool BankRouter::openDeposit(const std::string& passport, DepositKind kind, double initial) {
+    BankClient& c = route(passport);
+    c.openDeposit(passport, kind, initial);
+    return call(c).ok();
+}
+
+bool BankRouter::topUpDeposit(const std::string& passport, double value) {
+    BankClient& c = route(passport);
+    c.topUp(passport, value);
+    return call(c).ok();
+}
+
+std::optional<BankRouter::ClientInfo> BankRouter::getClient(const std::string& passport) {
+    BankClient& c = route(passport);
+    c.getClient(passport);
+    BankClient::Response r = call(c);
+    if (!r.ok()) return std::nullopt;
+    return ClientInfo{ std::move(r.name), r.hasDeposit };
+}
+
+double BankRouter::calcTotalYearInterest() {
+    for (auto& c : parts) {
+        c.totalInterest();
+        c.flush();
+    }
+    double total = 0.0;
+    for (auto& c : parts) {
+        BankClient::Response r = call(c);
+        if (!r.ok()) throw std::runtime_error("раздел не посчитал проценты");
+        total += r.value;
+    }
+    return total;
+}
+
+bool BankRouter::setRate(DepositKind kind, double rate) {
+    for (auto& c : parts) {
+        c.setRate(kind, rate);
+        c.flush();
+    }
+    bool ok = true;
+    for (auto& c : parts) ok = call(c).ok() && ok;
+    return ok;
+}
+
+std::vector<BankRouter::PartitionStats> BankRouter::stats() {
+    for (auto& c : parts) {
+        c.stats();
+        c.flush();
+    }
+    std::vector<PartitionStats> result;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        BankClient::Response r = call(parts[i]);
+        result.push_back(PartitionStats{ endpoints[i], r.clients, r.deposits });
+    }
+    return result;
+}
+
+// ответ GET_CLIENT нового раздела - та же запись, что отдал SCAN старого
+static bool sameClient(const BankClient::Response& r, const protocol::ClientEntry& e) {
+    if (!r.ok() || r.name != e.name || r.hasDeposit != e.hasDeposit) return false;
+    return !e.hasDeposit || (r.kind == e.kind && r.amount == e.amount);
+}
+
+size_t BankRouter::repartition(const std::vector<std::string>& newEndpoints) {
+    if (newEndpoints.empty()) throw std::invalid_argument("нет ни одного раздела");
+    for (size_t i = 0; i < newEndpoints.size(); ++i) {
+        if (std::find(newEndpoints.begin(), newEndpoints.begin() + i, newEndpoints[i]) != newEndpoints.begin() + i) {
+            throw std::invalid_argument("процесс указан дважды: " + newEndpoints[i]);
+        }
+    }
+
+    // все участники переноса: сначала новые разделы по порядку, затем убираемые процессы.
+    // уже открытые соединения переиспользуются
+    std::vector<std::string> all = newEndpoints;
+    for (const auto& e : endpoints) {
+        if (std::find(all.begin(), all.end(), e) == all.end()) all.push_back(e);
+    }
+    std::vector<std::unique_ptr<BankClient>> opened;
+    std::vector<BankClient*> conn;
+    for (const auto& e : all) {
+        auto old = std::find(endpoints.begin(), endpoints.end(), e);
+        if (old != endpoints.end()) {
+            conn.push_back(&parts[old - endpoints.begin()]);
+        }
+        else {
+            opened.push_back(std::make_unique<BankClient>(connect(e)));
+            conn.push_back(opened.back().get());
+        }
+    }
+
+    parts[0].getRates();
+    BankClient::Response rates = call(parts[0]);
+    if (!rates.ok()) throw std::runtime_error("раздел не отдал ставки: " + endpoints[0]);
+    const uint32_t n = static_cast<uint32_t>(newEndpoints.size());
+    for (uint32_t i = 0; i < n; ++i) {
+        for (int k = 0; k < 3; ++k) conn[i]->setRate(static_cast<DepositKind>(k + 1), rates.rates[k]);
+        while (conn[i]->inFlight() > 0) call(*conn[i]);
+    }
+
+    size_t moved = 0;
+    for (size_t src = 0; src < all.size(); ++src) {
+        BankClient& from = *conn[src];
+        uint32_t keep = src < n ? static_cast<uint32_t>(src) : protocol::NO_PARTITION;
+        std::string cursor;
+        bool done = false;
+        while (!done) {
+            from.scan(n, keep, cursor, SCAN_BATCH);
+            BankClient::Response batch = call(from);
+            if (!batch.ok()) throw std::runtime_error("раздел не отдал клиентов: " + all[src]);
+
+            // номера записей в порядке запросов к каждому разделу: ответы приходят в том же порядке
+            const std::vector<protocol::ClientEntry>& entries = batch.entries;
+            std::vector<std::vector<size_t>> sent(n);
+            for (size_t j = 0; j < entries.size(); ++j) {
+                const auto& e = entries[j];
+                uint32_t target = partitionOf(e.passport, n);
+                BankClient& to = *conn[target];
+                to.addClient(e.name, e.passport);
+                sent[target].push_back(j);
+                if (e.hasDeposit) {
+                    to.openDeposit(e.passport, static_cast<DepositKind>(e.kind), e.amount);
+                    sent[target].push_back(j);
+                }
+            }
+            for (uint32_t i = 0; i < n; ++i) conn[i]->flush();
+            std::vector<char> rejected(entries.size(), 0);
+            for (uint32_t i = 0; i < n; ++i) {
+                for (size_t j : sent[i]) {
+                    if (!call(*conn[i]).ok()) rejected[j] = 1;
+                }
+            }
+
+            // REJECTED - клиент уже скопирован прерванным прошлым переносом или в новом разделе
+            // другой клиент с тем же паспортом: старая запись удаляется, только если новая совпадает
+            std::vector<std::vector<size_t>> checked(n);
+            for (size_t j = 0; j < entries.size(); ++j) {
+                if (!rejected[j]) continue;
+                uint32_t target = partitionOf(entries[j].passport, n);
+                conn[target]->getClient(entries[j].passport);
+                checked[target].push_back(j);
+            }
+            std::string conflict;
+            for (uint32_t i = 0; i < n; ++i) {
+                conn[i]->flush();
+                for (size_t j : checked[i]) {
+                    BankClient::Response r = call(*conn[i]);
+                    if (!sameClient(r, entries[j]) && conflict.empty()) conflict = entries[j].passport + " в " + all[i];
+                }
+            }
+            if (!conflict.empty()) throw std::runtime_error("в новом разделе другой клиент с паспортом " + conflict);
+
+            for (const auto& e : batch.entries) from.removeClient(e.passport);
+            while (from.inFlight() > 0) call(from);
+
+            moved += batch.entries.size();
+            cursor = std::move(batch.cursor);
+            done = batch.done;
+        }
+    }
+
+    std::vector<BankClient> next;
+    next.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) next.push_back(std::move(*conn[i]));
+    parts = std::move(next);
+    endpoints = newEndpoints;
+    return moved;
+}
@@ -0,0 +1,72 @@
+// router.h
+#pragma once
+// Bank, разбитый на N процессов bank_server (только Linux). каждый процесс хранит клиентов
+// своего диапазона хеша паспорта (partition.h): операции с одним клиентом уходят в его раздел,
+// проценты по всем вкладам собираются со всех разделов параллельно, ставки рассылаются всем.
+//
+//   BankRouter router({ "/tmp/bank0.sock", "/tmp/bank1.sock", "7502" });  // путь сокета или TCP-порт
+//   router.topUpDeposit(passport, 100.0);
+//   router.repartition({ "/tmp/bank0.sock", "/tmp/bank1.sock", "7502", "/tmp/bank3.sock" });
+//
+// серверы о разбиении не знают - раскладку держит роутер, поэтому все роутеры одного кластера
+// должны работать с одним и тем же списком процессов в одном порядке.
+// ошибки соединения и неожиданные ответы - std::runtime_error; после них роутер нужно создать заново
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "bank.h"
+#include "client.h"
+
+class BankRouter {
+public:
+    struct ClientInfo {
+        std::string name;
+        bool hasDeposit{ false };
+    };
+
+    struct PartitionStats {
+        std::string endpoint;
+        uint64_t clients{ 0 };
+        uint64_t deposits{ 0 };
+    };
+
+    static constexpr uint16_t SCAN_BATCH = 256; // клиентов за один шаг переноса
+
+private:
+    std::vector<std::string> endpoints;
+    std::vector<BankClient> parts;
+
+    BankClient::Response call(BankClient& c);
+
+public:
+    explicit BankRouter(const std::vector<std::string>& endpoints);
+
+    static BankClient connect(const std::string& endpoint);
+
+    size_t partitions() const { return parts.size(); }
+    const std::vector<std::string>& endpointList() const { return endpoints; }
+
+    // соединение с разделом клиента - для конвейера: запросы в него, ответы через next()
+    BankClient& route(const std::string& passport);
+    BankClient& partition(size_t i) { return parts[i]; }
+
+    bool addClient(const std::string& name, const std::string& passport);
+    bool openDeposit(const std::string& passport, DepositKind kind, double initial);
+    bool topUpDeposit(const std::string& passport, double value);
+    std::optional<ClientInfo> getClient(const std::string& passport);
+
+    // запросы уходят во все разделы сразу, ответы складываются
+    double calcTotalYearInterest();
+    bool setRate(DepositKind kind, double rate);
+    std::vector<PartitionStats> stats();
+
+    // переносит клиентов со вкладами так, чтобы каждый лежал в newEndpoints[partitionOf(паспорт, N)].
+    // процессы могут добавляться и убираться (убранные остаются пустыми), новые получают ставки
+    // первого из прежних разделов. клиент сначала
+    // копируется в новый раздел и только потом удаляется из старого, поэтому прерванный перенос
+    // можно просто запустить заново: если копия уже есть, она сверяется со старой записью (имя и вклад).
+    // другой клиент с тем же паспортом в новом разделе - std::runtime_error, старая запись остаётся.
+    // на время переноса остальные операции с кластером нужно остановить. возвращает число перенесённых клиентов
+    size_t repartition(const std::vector<std::string>& newEndpoints);
+};
@@ -0,0 +1,696 @@
+// server.cpp
+// bank_server: один Bank на много локальных процессов (только Linux, epoll).
+//
+//   bank_server --unix /tmp/bank.sock
+//   bank_server --tcp 7500              (слушает только 127.0.0.1)
+//   bank_server --unix /tmp/bank.sock --replication /tmp/bank.repl    ведущий
+//   bank_server --unix /tmp/replica.sock --follow /tmp/bank.repl      последователь, только чтение
+//
+// однопоточный цикл событий: Bank не потокобезопасен, а операции над ним короче системных вызовов.
+// все целые кадры из прочитанного куска обрабатываются подряд, ответы копятся в буфере соединения
+// и уходят одним send - так конвейер из сотен запросов стоит пары системных вызовов.
+// протокол - protocol.h, клиент - client.h, репликация - replication.h
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "bank.h"
+#include "partition.h"
+#include "protocol.h"
+#include "replication.h"
+
+using protocol::Command;
+using protocol::Status;
+
+// пока клиент не забирает ответы, больше этого его запросы не читаются
+constexpr size_t MAX_PENDING_OUTPUT = 4 * 1024 * 1024;
+constexpr size_t READ_CHUNK = 64 * 1024;
+// последователь, у которого столько записей журнала не отправлено сверх догоняющей части, отключается;
+// переподключившись, он догонит по хвосту журнала или по снимку
+constexpr size_t MAX_REPLICA_BACKLOG = 64 * 1024 * 1024;
+// запросов снимка за один проход цикла событий на последователя
+constexpr size_t SNAPSHOT_SLICE = 4096;
+constexpr auto RECONNECT_INTERVAL = std::chrono::seconds(1);
+
+enum class Role {
+    CLIENT,   // запросы protocol.h
+    REPLICA,  // последователь у ведущего: HELLO, затем поток журнала
+    UPSTREAM, // соединение последователя с ведущим
+};
+
+struct Connection {
+    int fd{ -1 };
+    Role role{ Role::CLIENT };
+    bool streaming{ false };  // REPLICA после HELLO
+    size_t backlogLimit{ 0 }; // REPLICA: предел неотправленного
+    std::optional<replication::SnapshotStream> snapshot; // REPLICA: снимок ещё отправляется
+    std::string in;
+    size_t inPos{ 0 };
+    std::string out;
+    size_t outPos{ 0 };
+    uint32_t events{ 0 }; // на что подписан в epoll
+};
+
+static bool validKind(uint8_t k) {
+    return k >= 1 && k <= 3;
+}
+
+static bool validField(const std::string& s) {
+    return s.size() <= protocol::MAX_FIELD;
+}
+
+// в ответ SCAN записей не больше, чем помещается в половину кадра (паспорт и имя ограничены MAX_FIELD)
+constexpr size_t SCAN_REPLY_BUDGET = protocol::MAX_FRAME / 2;
+
+// клиенты после курсора, принадлежащие не разделу keep; просмотр останавливается на пределе записей
+// или размера ответа, курсор - последний просмотренный паспорт
+static void scan(const Bank& bank, uint32_t partitions, uint32_t keep, const std::string& after,
+                 uint16_t limit, protocol::FrameWriter& reply) {
+    std::string records;
+    protocol::FrameWriter entries(records);
+    uint16_t count = 0;
+    bool done = true;
+    std::string cursor = after;
+    bank.forEachClientAfter(after, [&](const Client& c) {
+        if (count == limit || records.size() >= SCAN_REPLY_BUDGET) {
+            done = false;
+            return false;
+        }
+        cursor = c.getPassport();
+        if (partitionOf(cursor, partitions) == keep) return true;
+        const Deposit* d = c.hasDeposit() ? bank.getDeposit(cursor) : nullptr;
+        entries.str(cursor).str(c.getName()).u8(d ? 1 : 0)
+            .u8(d ? static_cast<uint8_t>(d->getKind()) : 0).f64(d ? d->getAmount() : 0.0);
+        ++count;
+        return true;
+    });
+    // тело записей без своего заголовка длины
+    reply.u8(static_cast<uint8_t>(Status::OK)).u8(done ? 1 : 0).str(cursor).u16(count);
+    reply.raw(records.data() + 4, records.size() - 4);
+}
+
+// выполняет один запрос и дописывает ответ в out
+static void dispatch(Bank& bank, const char* body, size_t size, std::string& out) {
+    protocol::FrameReader in(body, size);
+    protocol::FrameWriter reply(out);
+    auto complete = [&] { return in.ok() && in.atEnd(); };
+    auto answer = [&](bool ok) { reply.u8(static_cast<uint8_t>(ok ? Status::OK : Status::REJECTED)); };
+    auto bad = [&] { reply.u8(static_cast<uint8_t>(Status::BAD_REQUEST)); };
+
+    switch (static_cast<Command>(in.u8())) {
+    case Command::ADD_CLIENT: {
+        std::string passport = in.str();
+        std::string name = in.str();
+        if (!complete() || !validField(passport) || !validField(name)) bad();
+        else answer(bank.addClient(name, passport));
+        break;
+    }
+    case Command::OPEN_DEPOSIT: {
+        std::string passport = in.str();
+        uint8_t kind = in.u8();
+        double amount = in.f64();
+        if (!complete() || !validKind(kind) || !std::isfinite(amount)) bad();
+        else answer(bank.openDeposit(passport, static_cast<DepositKind>(kind), amount));
+        break;
+    }
+    case Command::TOP_UP: {
+        std::string passport = in.str();
+        double value = in.f64();
+        if (!complete() || !std::isfinite(value)) bad();
+        else answer(bank.topUpDeposit(passport, value));
+        break;
+    }
+    case Command::GET_CLIENT: {
+        std::string passport = in.str();
+        if (!complete()) {
+            bad();
+            break;
+        }
+        const Client* c = bank.getClient(passport);
+        if (!c) {
+            reply.u8(static_cast<uint8_t>(Status::NOT_FOUND));
+            break;
+        }
+        const Deposit* d = c->hasDeposit() ? bank.getDeposit(passport) : nullptr;
+        reply.u8(static_cast<uint8_t>(Status::OK)).str(c->getName()).u8(d ? 1 : 0)
+            .u8(d ? static_cast<uint8_t>(d->getKind()) : 0).f64(d ? d->getAmount() : 0.0);
+        break;
+    }
+    case Command::TOTAL_INTEREST:
+        if (!complete()) bad();
+        else reply.u8(static_cast<uint8_t>(Status::OK)).f64(bank.calcTotalYearInterest());
+        break;
+    case Command::SET_RATE: {
+        uint8_t kind = in.u8();
+        double rate = in.f64();
+        if (!complete() || !validKind(kind) || !std::isfinite(rate)) bad();
+        else if (rate < 0) answer(false);
+        else {
+            bank.rates().setRate(static_cast<DepositKind>(kind), rate);
+            answer(true);
+        }
+        break;
+    }
+    case Command::SCAN: {
+        uint32_t partitions = in.u32();
+        uint32_t keep = in.u32();
+        std::string after = in.str();
+        uint16_t limit = in.u16();
+        if (!complete() || partitions == 0 || limit == 0) bad();
+        else scan(bank, partitions, keep, after, limit, reply);
+        break;
+    }
+    case Command::REMOVE_CLIENT: {
+        std::string passport = in.str();
+        if (!complete()) bad();
+        else if (bank.removeClient(passport)) answer(true);
+        else reply.u8(static_cast<uint8_t>(Status::NOT_FOUND));
+        break;
+    }
+    case Command::STATS:
+        if (!complete()) bad();
+        else reply.u8(static_cast<uint8_t>(Status::OK)).u64(bank.clientCount()).u64(bank.depositCount());
+        break;
+    case Command::GET_RATES:
+        if (!complete()) bad();
+        else {
+            reply.u8(static_cast<uint8_t>(Status::OK));
+            for (int k = 1; k <= 3; ++k) reply.f64(bank.rates().getRate(static_cast<DepositKind>(k)));
+        }
+        break;
+    default:
+        bad();
+        break;
+    }
+    reply.finish();
+}
+
+class Server {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Bank& bank;
+    int epfd{ -1 };
+    int listenFd{ -1 };
+    int signalFd{ -1 };
+    std::string unixPath;
+    std::unordered_map<int, Connection> connections;
+
+    // ведущий
+    int replicationFd{ -1 };
+    std::string replicationPath;
+    std::optional<replication::Log> log;
+    std::vector<int> replicas;
+    Clock::time_point lastHeartbeat;
+
+    // последователь
+    std::string followPath;
+    replication::Follower follower;
+    int upstreamFd{ -1 };
+    Clock::time_point lastConnectAttempt;
+    std::string scratch; // ответы на запросы из журнала никому не нужны
+
+    bool following() const { return !followPath.empty(); }
+
+    void watch(int fd, uint32_t events, int op) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        if (epoll_ctl(epfd, op, fd, &ev) < 0) std::perror("epoll_ctl");
+    }
+
+    void close(Connection& c) {
+        if (c.role == Role::REPLICA) replicas.erase(std::remove(replicas.begin(), replicas.end(), c.fd), replicas.end());
+        if (c.role == Role::UPSTREAM) {
+            upstreamFd = -1;
+            std::fprintf(stderr, "связь с ведущим потеряна\n");
+        }
+        epoll_ctl(epfd, EPOLL_CTL_DEL, c.fd, nullptr);
+        ::close(c.fd);
+        connections.erase(c.fd);
+    }
+
+    Connection& add(int fd, Role role) {
+        Connection& c = connections[fd];
+        c.fd = fd;
+        c.role = role;
+        c.events = EPOLLIN | EPOLLRDHUP;
+        watch(fd, c.events, EPOLL_CTL_ADD);
+        return c;
+    }
+
+    void accept(int from, Role role) {
+        while (true) {
+            int fd = accept4(from, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) std::perror("accept");
+                return;
+            }
+            if (role == Role::CLIENT && unixPath.empty()) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            }
+            add(fd, role);
+        }
+    }
+
+    static void status(std::string& out, Status s) {
+        protocol::FrameWriter(out).u8(static_cast<uint8_t>(s)).finish();
+    }
+
+    void replicaStatus(std::string& out) const {
+        protocol::FrameWriter reply(out);
+        reply.u8(static_cast<uint8_t>(Status::OK));
+        if (following()) {
+            reply.u8(2).u64(follower.appliedSeq()).f64(follower.lagSeconds()).u32(upstreamFd >= 0 ? 1 : 0);
+        }
+        else if (log) {
+            reply.u8(1).u64(log->lastSeq()).f64(0.0).u32(static_cast<uint32_t>(replicas.size()));
+        }
+        else {
+            reply.u8(0).u64(0).f64(0.0).u32(0);
+        }
+        reply.finish();
+    }
+
+    // удаляемый клиент мог ещё не попасть в отправляемые снимки (replication::SnapshotStream)
+    void keepForSnapshots(const char* body, size_t size) {
+        protocol::FrameReader in(body, size);
+        in.u8();
+        std::string passport = in.str();
+        const Client* client = in.ok() ? bank.getClient(passport) : nullptr;
+        if (!client) return;
+        for (int fd : replicas) {
+            Connection& r = connections[fd];
+            if (r.snapshot) r.snapshot->removing(*client);
+        }
+    }
+
+    // запрос клиента; у ведущего выполненное изменение уходит в журнал и всем последователям
+    void execute(Connection& c, const char* body, size_t size) {
+        Command command = static_cast<Command>(static_cast<uint8_t>(body[0]));
+        if (command == Command::REPLICA_STATUS) {
+            if (size == 1) replicaStatus(c.out);
+            else status(c.out, Status::BAD_REQUEST);
+            return;
+        }
+        if (following() && replication::isWrite(command)) {
+            status(c.out, Status::READ_ONLY);
+            return;
+        }
+        if (following() && !follower.ready()) {
+            status(c.out, Status::UNAVAILABLE);
+            return;
+        }
+        if (command == Command::REMOVE_CLIENT) keepForSnapshots(body, size);
+        size_t at = c.out.size();
+        dispatch(bank, body, size, c.out);
+        if (log && replication::isWrite(command) && static_cast<Status>(c.out[at + 4]) == Status::OK) {
+            const std::string& entry = log->append(body, size);
+            for (int fd : replicas) {
+                Connection& r = connections[fd];
+                if (!r.snapshot) r.out += entry;
+            }
+        }
+    }
+
+    // недостающие записи журнала после applied, дальше последователь получает их по мере появления
+    void startLog(Connection& c, uint64_t applied) {
+        log->catchUp(applied, c.out);
+        c.backlogLimit = c.out.size() - c.outPos + MAX_REPLICA_BACKLOG;
+    }
+
+    // HELLO от последователя: хвост журнала сразу или снимок частями в tick()
+    bool hello(Connection& c, const char* body, size_t size) {
+        protocol::FrameReader in(body, size);
+        auto type = static_cast<replication::Message>(in.u8());
+        uint64_t epoch = in.u64();
+        uint64_t applied = in.u64();
+        if (c.streaming || type != replication::Message::HELLO || !in.ok() || !in.atEnd()) return false;
+        if (log->canCatchUp(epoch, applied)) startLog(c, applied);
+        else c.snapshot.emplace(bank, log->epochId(), log->lastSeq());
+        c.streaming = true;
+        replicas.push_back(c.fd);
+        return true;
+    }
+
+    // снимок пишется, только когда прошлая часть почти ушла: буфер не растёт быстрее сокета
+    static bool wantsSnapshotSlice(const Connection& c) {
+        return c.snapshot && c.out.size() - c.outPos < MAX_PENDING_OUTPUT / 4;
+    }
+
+    // следующая часть снимка; после SNAPSHOT_END - записи журнала, появившиеся за время снимка.
+    // если хвост журнала их уже не хранит, снимок начинается заново
+    void sendSnapshotSlice(Connection& c) {
+        if (!c.snapshot->writeSlice(bank, SNAPSHOT_SLICE, c.out)) return;
+        uint64_t seq = c.snapshot->snapshotSeq();
+        if (log->canCatchUp(log->epochId(), seq)) {
+            c.snapshot.reset();
+            startLog(c, seq);
+        }
+        else {
+            c.snapshot.emplace(bank, log->epochId(), log->lastSeq());
+        }
+    }
+
+    // false - соединение надо закрыть
+    bool handleFrame(Connection& c, const char* body, size_t size) {
+        switch (c.role) {
+        case Role::CLIENT:
+            execute(c, body, size);
+            return true;
+        case Role::REPLICA:
+            return hello(c, body, size);
+        case Role::UPSTREAM: {
+            std::string_view request;
+            if (!follower.apply(bank, body, size, request)) return false;
+            if (!request.empty()) {
+                dispatch(bank, request.data(), request.size(), scratch);
+                scratch.clear();
+            }
+            return true;
+        }
+        }
+        return false;
+    }
+
+    // false - соединение надо закрыть (испорченный кадр)
+    bool processFrames(Connection& c) {
+        while (true) {
+            const char* data = c.in.data() + c.inPos;
+            size_t avail = c.in.size() - c.inPos;
+            long long len = protocol::peekFrameLength(data, avail);
+            if (len < 0) break;
+            if (len == 0 || len > protocol::MAX_FRAME) return false;
+            if (avail < 4 + static_cast<size_t>(len)) break;
+            if (!handleFrame(c, data + 4, static_cast<size_t>(len))) return false;
+            c.inPos += 4 + static_cast<size_t>(len);
+        }
+        c.in.erase(0, c.inPos);
+        c.inPos = 0;
+        return true;
+    }
+
+    // false - соединение закрыто с той стороны или ошибка
+    bool readAvailable(Connection& c) {
+        // за одно событие читаем не больше 16 кусков, чтобы не задерживать остальные соединения
+        for (int i = 0; i < 16; ++i) {
+            size_t old = c.in.size();
+            c.in.resize(old + READ_CHUNK);
+            ssize_t n = recv(c.fd, &c.in[old], READ_CHUNK, 0);
+            c.in.resize(old + (n > 0 ? static_cast<size_t>(n) : 0));
+            if (n > 0) {
+                if (static_cast<size_t>(n) < READ_CHUNK) return true;
+                continue;
+            }
+            if (n == 0) return false;
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        return true;
+    }
+
+    // false - ошибка записи
+    bool flush(Connection& c) {
+        while (c.outPos < c.out.size()) {
+            ssize_t n = send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+            if (n > 0) {
+                c.outPos += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            return false;
+        }
+        if (c.outPos == c.out.size()) {
+            c.out.clear();
+            c.outPos = 0;
+        }
+        return true;
+    }
+
+    // подписка по состоянию буферов: ждём записи, если ответы не ушли; не читаем, пока их слишком много
+    void updateEvents(Connection& c) {
+        size_t pending = c.out.size() - c.outPos;
+        uint32_t events = EPOLLRDHUP;
+        if (pending < MAX_PENDING_OUTPUT) events |= EPOLLIN;
+        if (pending > 0) events |= EPOLLOUT;
+        if (events != c.events) {
+            c.events = events;
+            watch(c.fd, events, EPOLL_CTL_MOD);
+        }
+    }
+
+    void handle(Connection& c, uint32_t events) {
+        if (events & EPOLLERR) {
+            close(c);
+            return;
+        }
+        bool open = true;
+        if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+            open = readAvailable(c);
+            if (!processFrames(c)) {
+                close(c);
+                return;
+            }
+        }
+        if (!flush(c) || (!open && c.outPos == c.out.size())) {
+            close(c);
+            return;
+        }
+        // клиент закрыл свою сторону, но ещё читает - дописываем ответы и закрываем
+        if (!open) {
+            c.events = EPOLLOUT;
+            watch(c.fd, c.events, EPOLL_CTL_MOD);
+            return;
+        }
+        updateEvents(c);
+    }
+
+    // unix-сокет, готовый к listen, или -1
+    static int bindUnix(const std::string& path) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            std::fprintf(stderr, "слишком длинный путь сокета\n");
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        unlink(path.c_str());
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::perror("bind");
+            if (fd >= 0) ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // соединение с ведущим и HELLO; при неудаче следующая попытка через RECONNECT_INTERVAL
+    void connectUpstream() {
+        lastConnectAttempt = Clock::now();
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, followPath.c_str(), followPath.size() + 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return;
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            ::close(fd);
+            return;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        Connection& c = add(fd, Role::UPSTREAM);
+        follower.hello(c.out);
+        upstreamFd = fd;
+        std::fprintf(stderr, "подключён к ведущему %s\n", followPath.c_str());
+        if (!flush(c)) close(c);
+        else updateEvents(c);
+    }
+
+    // после каждого прохода цикла: части снимков, записи журнала и пульс последователям, переподключение к ведущему
+    void tick() {
+        Clock::time_point now = Clock::now();
+        if (log && now - lastHeartbeat >= replication::HEARTBEAT_INTERVAL) {
+            lastHeartbeat = now;
+            for (int fd : replicas) {
+                Connection& c = connections[fd];
+                if (!c.snapshot) log->heartbeat(c.out);
+            }
+        }
+        std::vector<int> fds = replicas;
+        for (int fd : fds) {
+            Connection& c = connections[fd];
+            if (wantsSnapshotSlice(c)) sendSnapshotSlice(c);
+            if ((!c.snapshot && c.out.size() - c.outPos > c.backlogLimit) || !flush(c)) {
+                std::fprintf(stderr, "последователь отключён: не успевает за журналом\n");
+                close(c);
+                continue;
+            }
+            // уже отправленное в предел больше не входит: дальше он считается от живого потока
+            c.backlogLimit = std::min(c.backlogLimit, c.out.size() - c.outPos + MAX_REPLICA_BACKLOG);
+            updateEvents(c);
+        }
+        if (following() && upstreamFd < 0 && now - lastConnectAttempt >= RECONNECT_INTERVAL) connectUpstream();
+    }
+
+public:
+    explicit Server(Bank& bank) : bank(bank) {}
+
+    ~Server() {
+        for (auto& kv : connections) ::close(kv.first);
+        if (listenFd >= 0) ::close(listenFd);
+        if (replicationFd >= 0) ::close(replicationFd);
+        if (signalFd >= 0) ::close(signalFd);
+        if (epfd >= 0) ::close(epfd);
+        if (!unixPath.empty()) unlink(unixPath.c_str());
+        if (!replicationPath.empty()) unlink(replicationPath.c_str());
+    }
+
+    bool listenUnix(const std::string& path) {
+        listenFd = bindUnix(path);
+        if (listenFd < 0) return false;
+        unixPath = path;
+        return true;
+    }
+
+    bool listenTcp(uint16_t port) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        if (listenFd >= 0) setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::perror("bind");
+            return false;
+        }
+        return true;
+    }
+
+    // ведущий: последователи подключаются к этому unix-сокету
+    bool listenReplication(const std::string& path) {
+        replicationFd = bindUnix(path);
+        if (replicationFd < 0 || ::listen(replicationFd, SOMAXCONN) < 0) return false;
+        replicationPath = path;
+        log.emplace();
+        return true;
+    }
+
+    // последователь ведущего с сокетом репликации path
+    bool follow(const std::string& path) {
+        if (path.size() >= sizeof(sockaddr_un{}.sun_path)) {
+            std::fprintf(stderr, "слишком длинный путь сокета\n");
+            return false;
+        }
+        followPath = path;
+        return true;
+    }
+
+    // до SIGINT/SIGTERM
+    int run() {
+        if (::listen(listenFd, SOMAXCONN) < 0) {
+            std::perror("listen");
+            return 1;
+        }
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGINT);
+        sigaddset(&mask, SIGTERM);
+        sigprocmask(SIG_BLOCK, &mask, nullptr);
+        signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (signalFd < 0 || epfd < 0) {
+            std::perror("epoll");
+            return 1;
+        }
+        watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+        watch(signalFd, EPOLLIN, EPOLL_CTL_ADD);
+        if (replicationFd >= 0) watch(replicationFd, EPOLLIN, EPOLL_CTL_ADD);
+        if (following()) connectUpstream();
+        // с репликацией просыпаемся и без событий: пульс и переподключение
+        int timeoutMs = (log || following()) ? static_cast<int>(replication::HEARTBEAT_INTERVAL.count()) : -1;
+
+        epoll_event events[256];
+        while (true) {
+            // пока есть кому писать снимок, цикл не засыпает
+            bool slicing = std::any_of(replicas.begin(), replicas.end(),
+                [this](int fd) { return wantsSnapshotSlice(connections[fd]); });
+            int n = epoll_wait(epfd, events, 256, slicing ? 0 : timeoutMs);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                std::perror("epoll_wait");
+                return 1;
+            }
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == signalFd) return 0;
+                if (fd == listenFd) {
+                    accept(listenFd, Role::CLIENT);
+                    continue;
+                }
+                if (fd == replicationFd) {
+                    accept(replicationFd, Role::REPLICA);
+                    continue;
+                }
+                auto it = connections.find(fd);
+                if (it != connections.end()) handle(it->second, events[i].events);
+            }
+            if (timeoutMs >= 0) tick();
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    std::string unixPath;
+    std::string replicationPath;
+    std::string followPath;
+    long port = -1;
+    bool good = argc % 2 == 1;
+    for (int i = 1; good && i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--unix") == 0) unixPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--tcp") == 0) port = std::strtol(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--replication") == 0) replicationPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--follow") == 0) followPath = argv[i + 1];
+        else good = false;
+    }
+    if (!good || (unixPath.empty() && (port <= 0 || port > 65535)) || (!unixPath.empty() && port > 0) ||
+        (!replicationPath.empty() && !followPath.empty())) {
+        std::fprintf(stderr, "использование: %s --unix путь | --tcp порт [--replication путь | --follow путь]\n", argv[0]);
+        return 1;
+    }
+
+#ifdef BANK_WITH_METRICS
+    const char* metricsFile = std::getenv("BANK_METRICS_FILE");
+    metrics::PeriodicDump metricsDump(metricsFile ? metricsFile : "bank_metrics.prom", std::chrono::seconds(10));
+#endif
+
+    Bank& bank = Bank::getInstance();
+    int code = 0;
+    {
+        Server server(bank);
+        bool ok = unixPath.empty() ? server.listenTcp(static_cast<uint16_t>(port)) : server.listenUnix(unixPath);
+        if (ok && !replicationPath.empty()) ok = server.listenReplication(replicationPath);
+        if (ok && !followPath.empty()) ok = server.follow(followPath);
+        code = ok ? server.run() : 1;
+    }
+    bank.clear();
+    return code;
+}
@@ -0,0 +1,110 @@
+// server_bench.cpp
+// нагрузка на bank_server из нескольких соединений с конвейером:
+//
+//   bank_server_bench --unix /tmp/bank.sock [--threads 4] [--depth 128] [--clients 1000] [--seconds 2] [--lookups 0.9]
+//
+// сначала заводит clients клиентов со вкладами, потом каждый поток шлёт пачки по depth запросов
+// (доля lookups - getClient, остальное - пополнения) и ждёт ответы на всю пачку
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "client.h"
+
+struct Options {
+    std::string unixPath;
+    long port{ -1 };
+    int threads{ 4 };
+    int depth{ 128 };
+    int clients{ 1000 };
+    double seconds{ 2.0 };
+    double lookups{ 0.9 };
+};
+
+static BankClient connectTo(const Options& o) {
+    return o.unixPath.empty() ? BankClient::connectTcp(static_cast<uint16_t>(o.port)) : BankClient::connectUnix(o.unixPath);
+}
+
+static std::string passportOf(int i) {
+    return "bench" + std::to_string(i);
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        const char* v = argv[i + 1];
+        if (arg == "--unix") o.unixPath = v;
+        else if (arg == "--tcp") o.port = std::strtol(v, nullptr, 10);
+        else if (arg == "--threads") o.threads = std::atoi(v);
+        else if (arg == "--depth") o.depth = std::atoi(v);
+        else if (arg == "--clients") o.clients = std::atoi(v);
+        else if (arg == "--seconds") o.seconds = std::atof(v);
+        else if (arg == "--lookups") o.lookups = std::atof(v);
+    }
+    if ((o.unixPath.empty() && (o.port <= 0 || o.port > 65535)) || argc % 2 == 0 ||
+        o.threads < 1 || o.depth < 1 || o.clients < 1 || o.seconds <= 0) {
+        std::fprintf(stderr, "использование: %s --unix путь | --tcp порт [--threads N] [--depth N] [--clients N] [--seconds S] [--lookups 0..1]\n", argv[0]);
+        return 1;
+    }
+
+    try {
+        // заселение тоже конвейером, пачками по 1000
+        BankClient setup = connectTo(o);
+        for (int i = 0; i < o.clients; ++i) {
+            setup.addClient("client" + std::to_string(i), passportOf(i));
+            setup.openDeposit(passportOf(i), static_cast<DepositKind>(1 + i % 3), 1000.0);
+            if (setup.inFlight() >= 2000) while (setup.inFlight() > 0) setup.next();
+        }
+        while (setup.inFlight() > 0) setup.next();
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    std::atomic<bool> failed{ false };
+    std::vector<unsigned long long> done(o.threads, 0);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    auto stop = start + std::chrono::duration<double>(o.seconds);
+    for (int t = 0; t < o.threads; ++t) {
+        threads.emplace_back([&, t] {
+            try {
+                BankClient c = connectTo(o);
+                std::mt19937 rng(t + 1);
+                std::uniform_int_distribution<int> pick(0, o.clients - 1);
+                std::uniform_real_distribution<double> uniform(0.0, 1.0);
+                while (std::chrono::steady_clock::now() < stop) {
+                    for (int k = 0; k < o.depth; ++k) {
+                        std::string p = passportOf(pick(rng));
+                        if (uniform(rng) < o.lookups) c.getClient(p);
+                        else c.topUp(p, 1.0);
+                    }
+                    for (int k = 0; k < o.depth; ++k) {
+                        if (!c.next().ok()) throw std::runtime_error("запрос не выполнен");
+                    }
+                    done[t] += o.depth;
+                }
+            }
+            catch (const std::exception& e) {
+                std::fprintf(stderr, "поток %d: %s\n", t, e.what());
+                failed = true;
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    unsigned long long total = 0;
+    for (auto d : done) total += d;
+    std::printf("%llu операций за %.2f с: %.0f опер/с (%d соединений, конвейер %d)\n",
+                total, seconds, total / seconds, o.threads, o.depth);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+// accrual_test.cpp
+// AccrualJob: день, прерванный по deadline, продолжается с контрольной точки без повторного начисления;
+// после падения процесса посреди дня точка прошлого процесса не читается и итоги не удваиваются
+#include "test_util.h"
+#include "accrual.h"
+#include <fstream>
+#include <iterator>
+#if defined(__unix__)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const uint32_t DAY = 20000;
+// два полных раунда и часть третьего
+const size_t DEPOSITS = AccrualJob::ROUND_CHUNKS * DepositSnapshot::CHUNK * 5 / 2;
+
+// одна и та же книга в любом процессе
+Bank& MakeBank() {
+    Bank& bank = Bank::getInstance();
+    for (size_t i = 0; i < DEPOSITS; ++i) {
+        std::string passport = "p" + std::to_string(i);
+        bank.addClient("клиент", passport);
+        bank.openDeposit(passport, static_cast<DepositKind>(1 + i % 3), 1000.0 + static_cast<double>(i % 997) * 0.25);
+    }
+    return bank;
+}
+
+void DropBank() {
+    delete &Bank::getInstance();
+    Bank::destroyInstance();
+}
+
+// итоги одним потоком: порядок сложения тот же, поэтому суммы совпадают до последнего бита
+AccrualSummary Uninterrupted() {
+    AccrualSummary s = AccrualJob(MakeBank(), std::string(), 1).run(DAY);
+    DropBank();
+    return s;
+}
+
+bool SameTotals(const AccrualSummary& a, const AccrualSummary& b) {
+    return a.credited == b.credited && a.total == b.total &&
+        a.byKind[0] == b.byKind[0] && a.byKind[1] == b.byKind[1] && a.byKind[2] == b.byKind[2];
+}
+
+std::string ReadAll(const std::string& path) {
+    std::ifstream in(path);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void ResumesAfterDeadline(const AccrualSummary& full) {
+    test::TempFile checkpoint(".checkpoint");
+    Bank& bank = MakeBank();
+    AccrualJob job(bank, checkpoint.Path(), 1);
+
+    // окно уже закрыто: проходит только первый раунд
+    AccrualSummary first = job.run(DAY, AccrualJob::Clock::now());
+    CHECK(!first.complete);
+    CHECK(first.credited == AccrualJob::ROUND_CHUNKS * DepositSnapshot::CHUNK && first.skipped == 0);
+
+    AccrualSummary rest = job.run(DAY);
+    CHECK(rest.resumed && rest.complete);
+    // каждый вклад посчитан один раз: начисленные до перерыва - в credited с контрольной точки
+    CHECK(rest.credited + rest.skipped == bank.depositCount());
+    CHECK(SameTotals(rest, full));
+
+    // день закрыт: повторный запуск отдаёт его итоги и ничего не начисляет
+    double interest = bank.calcTotalYearInterest();
+    AccrualSummary again = job.run(DAY);
+    CHECK(again.complete && SameTotals(again, full));
+    CHECK(bank.calcTotalYearInterest() == interest);
+
+    // без контрольной точки день начинается заново: все вклады уже получили проценты раньше
+    AccrualSummary fresh = AccrualJob(bank, std::string(), 1).run(DAY);
+    CHECK(!fresh.resumed && fresh.credited == 0 && fresh.skipped == bank.depositCount());
+
+    // очищенный банк - уже другой: точка не подходит, runDue берёт только сегодняшний день
+    bank.clear();
+    std::vector<AccrualSummary> due = job.runDue(DAY + 3);
+    CHECK(due.size() == 1 && due[0].day == DAY + 3 && !due[0].resumed && due[0].credited == 0);
+    DropBank();
+}
+
+#if defined(__unix__)
+void CrashDoesNotDoubleCount(const AccrualSummary& full) {
+    test::TempFile checkpoint(".checkpoint");
+    pid_t child = fork();
+    CHECK(child >= 0);
+    if (child == 0) {
+        // первый раунд, контрольная точка - и процесс падает посреди дня
+        AccrualJob(MakeBank(), checkpoint.Path(), 1).run(DAY, AccrualJob::Clock::now());
+        std::raise(SIGKILL);
+    }
+    int status = 0;
+    CHECK(waitpid(child, &status, 0) == child && WIFSIGNALED(status));
+    CHECK(ReadAll(checkpoint.Path()).find("complete 0") != std::string::npos);
+
+    // новый процесс: те же вклады, но о начислениях прошлого процесса они не знают
+    AccrualSummary s = AccrualJob(MakeBank(), checkpoint.Path(), 1).run(DAY);
+    CHECK(!s.resumed && s.complete);
+    CHECK(SameTotals(s, full));
+    DropBank();
+}
+#endif
+
+} // namespace
+
+int main() {
+    AccrualSummary full = Uninterrupted();
+    CHECK(full.complete && full.credited == DEPOSITS);
+    ResumesAfterDeadline(full);
+#if defined(__unix__)
+    CrashDoesNotDoubleCount(full);
+#endif
+    return 0;
+}
@@ -0,0 +1,106 @@
+// deposit_book_test.cpp
+// DepositBook/DepositSnapshot: снимок не видит пополнений, переводов и удалений (перестановка последнего вклада)
+// на стыках кусков, а книга видит; скопированные при записи куски освобождаются вместе со снимком
+#include "test_util.h"
+#include "bank.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <optional>
+
+// сколько байт занято через new сейчас (размер хранится перед блоком) и сколько было выделений
+static std::atomic<long long> liveBytes{ 0 };
+static std::atomic<long long> allocations{ 0 };
+
+static void* countedAlloc(std::size_t size) {
+    void* raw = std::malloc(size + sizeof(std::max_align_t));
+    if (!raw) throw std::bad_alloc();
+    *static_cast<std::size_t*>(raw) = size;
+    liveBytes += static_cast<long long>(size);
+    ++allocations;
+    return static_cast<char*>(raw) + sizeof(std::max_align_t);
+}
+
+static void countedFree(void* p) noexcept {
+    if (!p) return;
+    void* raw = static_cast<char*>(p) - sizeof(std::max_align_t);
+    liveBytes -= static_cast<long long>(*static_cast<std::size_t*>(raw));
+    std::free(raw);
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
+
+namespace {
+
+const size_t CHUNK = DepositSnapshot::CHUNK;
+const size_t DEPOSITS = 3 * CHUNK + 10; // последний кусок - 10 вкладов
+
+std::string Passport(size_t i) {
+    return "p" + std::to_string(i);
+}
+
+double Initial(size_t i) {
+    return 100.0 + static_cast<double>(i);
+}
+
+void SnapshotKeepsOldBook() {
+    Bank& bank = Bank::getInstance();
+    for (size_t i = 0; i < DEPOSITS; ++i) {
+        bank.addClient("клиент", Passport(i));
+        bank.openDeposit(Passport(i), DepositKind::SAVINGS, Initial(i));
+    }
+    std::optional<DepositSnapshot> snap = bank.snapshot();
+    double interest = bank.calcTotalYearInterest();
+
+    // пишет в каждый кусок: перевод через стык первого и второго, пополнение третьего,
+    // удаления из первого переносят вклады из последнего, пока он не опустеет
+    CHECK(bank.transfer(Passport(CHUNK - 1), Passport(CHUNK), 7.0) == TransferStatus::OK);
+    CHECK(bank.topUpDeposit(Passport(2 * CHUNK), 5.0));
+    for (size_t i = 0; i < 10; ++i) CHECK(bank.removeClient(Passport(i)));
+
+    // книга - новая
+    CHECK(bank.depositCount() == 3 * CHUNK && bank.depositChunkCount() == 3);
+    CHECK(bank.getDeposit(Passport(CHUNK - 1))->getAmount() == Initial(CHUNK - 1) - 7.0);
+    CHECK(bank.getDeposit(Passport(CHUNK))->getAmount() == Initial(CHUNK) + 7.0);
+    CHECK(bank.getDeposit(Passport(2 * CHUNK))->getAmount() == Initial(2 * CHUNK) + 5.0);
+    CHECK(bank.getDeposit(Passport(0)) == nullptr);
+    for (size_t i = 3 * CHUNK; i < DEPOSITS; ++i) {
+        CHECK(bank.depositIndex(Passport(i)) < 10);
+        CHECK(bank.getDeposit(Passport(i))->getAmount() == Initial(i));
+    }
+
+    // снимок - прежний, вместе с опустевшим куском
+    CHECK(snap->depositCount() == DEPOSITS);
+    for (size_t i = 0; i < DEPOSITS; ++i) {
+        CHECK(snap->deposit(i).getClientPassport() == Passport(i));
+        CHECK(snap->deposit(i).getAmount() == Initial(i));
+    }
+    CHECK(snap->calcTotalYearInterest() == interest);
+
+    // старые куски держит только снимок: все четыре освобождаются вместе с ним
+    long long held = liveBytes;
+    snap.reset();
+    CHECK(held - liveBytes >= static_cast<long long>(4 * CHUNK * sizeof(Deposit)));
+
+    // без снимков запись куски больше не копирует
+    long long allocated = allocations;
+    CHECK(bank.topUpDeposit(Passport(2 * CHUNK), 5.0));
+    CHECK(bank.transfer(Passport(CHUNK - 1), Passport(CHUNK), 7.0) == TransferStatus::OK);
+    CHECK(allocations == allocated);
+
+    delete &bank;
+    Bank::destroyInstance();
+}
+
+} // namespace
+
+int main() {
+    SnapshotKeepsOldBook();
+    return 0;
+}
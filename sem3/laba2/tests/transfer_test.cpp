@@ -0,0 +1,125 @@
+// transfer_test.cpp
+// TransferExecutor: статусы переводов и суммы на вкладах те же, что у Bank::transfer по очереди пакета -
+// и на волнах меньше PARALLEL_WAVE (вызывающий поток), и на волнах через runParallel
+#include "test_util.h"
+#include "transfer.h"
+#include <limits>
+#include <random>
+
+namespace {
+
+const size_t DEPOSITS = TransferExecutor::PARALLEL_WAVE * 2 + 1000;
+
+std::string Passport(size_t i) {
+    return "p" + std::to_string(i);
+}
+
+// одна и та же книга для каждого прогона; у клиента "без вклада" вклада нет
+Bank& MakeBank() {
+    Bank& bank = Bank::getInstance();
+    for (size_t i = 0; i < DEPOSITS; ++i) {
+        bank.addClient("клиент", Passport(i));
+        bank.openDeposit(Passport(i), DepositKind::SAVINGS, 100.0 + static_cast<double>(i % 50));
+    }
+    bank.addClient("клиент", "без вклада");
+    return bank;
+}
+
+void DropBank() {
+    delete &Bank::getInstance();
+    Bank::destroyInstance();
+}
+
+// цепочка, отказы до волн и перерасход - мелкие волны
+std::vector<Transfer> Mixed() {
+    return {
+        { "p0", "p1", 50.0 },     // p1: 101 -> 151
+        { "p1", "p2", 140.0 },    // хватает только после первого перевода
+        { "p3", "p4", 1000.0 },   // перерасход
+        { "p5", "p5", 1.0 },
+        { "p5", "нет такого", 1.0 },
+        { "без вклада", "p5", 1.0 },
+        { "p6", "p7", 0.0 },
+        { "p6", "p7", -1.0 },
+        { "p6", "p7", std::numeric_limits<double>::quiet_NaN() },
+        { "p6", "p7", std::numeric_limits<double>::infinity() },
+        { "p2", "p3", 190.0 },    // p2: 102 + 140 = 242, p3 после отказа - 103
+        { "p3", "p0", 293.0 },    // ровно всё, что есть на p3
+    };
+}
+
+// первая волна - пары (2k, 2k + 1) на всех вкладах, дальше - случайные переводы, в том числе сверх остатка
+std::vector<Transfer> Wide() {
+    std::vector<Transfer> batch;
+    for (size_t k = 0; 2 * k + 1 < DEPOSITS; ++k) {
+        batch.push_back({ Passport(2 * k), Passport(2 * k + 1), 10.0 + static_cast<double>(k % 7) * 0.25 });
+    }
+    std::mt19937 rng(7);
+    for (size_t i = 0; i < DEPOSITS * 3; ++i) {
+        size_t from = rng() % DEPOSITS, to = rng() % DEPOSITS;
+        batch.push_back({ Passport(from), Passport(to), 1.0 + static_cast<double>(rng() % 600) * 0.25 });
+    }
+    return batch;
+}
+
+struct Outcome {
+    std::vector<std::vector<TransferStatus>> statuses;
+    std::vector<double> balances;
+};
+
+std::vector<double> Balances(const Bank& bank) {
+    std::vector<double> balances;
+    for (size_t i = 0; i < DEPOSITS; ++i) balances.push_back(bank.getDeposit(Passport(i))->getAmount());
+    return balances;
+}
+
+Outcome Sequential(const std::vector<std::vector<Transfer>>& batches) {
+    Outcome out;
+    Bank& bank = MakeBank();
+    for (const auto& batch : batches) {
+        out.statuses.emplace_back();
+        for (const Transfer& t : batch) out.statuses.back().push_back(bank.transfer(t.from, t.to, t.amount));
+    }
+    out.balances = Balances(bank);
+    DropBank();
+    return out;
+}
+
+void MatchesSequential() {
+    std::vector<std::vector<Transfer>> batches = { Mixed(), Wide(), Mixed() };
+    Outcome expected = Sequential(batches);
+
+    using S = TransferStatus;
+    CHECK((expected.statuses[0] == std::vector<S>{ S::OK, S::OK, S::INSUFFICIENT, S::SAME_DEPOSIT, S::NOT_FOUND,
+        S::NOT_FOUND, S::BAD_AMOUNT, S::BAD_AMOUNT, S::BAD_AMOUNT, S::BAD_AMOUNT, S::OK, S::OK }));
+    size_t insufficient = 0;
+    for (S s : expected.statuses[1]) insufficient += s == S::INSUFFICIENT;
+    CHECK(insufficient > 0 && insufficient < expected.statuses[1].size());
+
+    Bank& bank = MakeBank();
+    TransferExecutor exec(bank, 3);
+    Outcome actual;
+    for (size_t b = 0; b < batches.size(); ++b) {
+        actual.statuses.push_back(exec.execute(batches[b]));
+        const TransferExecutor::Stats& stats = exec.lastStats();
+        if (b == 1) {
+            CHECK(stats.parallelWaves > 0 && stats.parallelWaves < stats.waves);
+        }
+        else {
+            CHECK(stats.parallelWaves == 0 && stats.transfers == 5);
+        }
+    }
+    actual.balances = Balances(bank);
+    DropBank();
+
+    // переводы одного вклада идут в порядке пакета, поэтому суммы совпадают до последнего бита
+    CHECK(actual.statuses == expected.statuses);
+    CHECK(actual.balances == expected.balances);
+}
+
+} // namespace
+
+int main() {
+    MatchesSequential();
+    return 0;
+}
@@ -0,0 +1,137 @@
+// transfer.cpp
+#include "transfer.h"
+#include <algorithm>
+
+TransferExecutor::TransferExecutor(Bank& bank, size_t threads) : bank(bank) {
+    if (threads == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threads = hw > 1 ? hw - 1 : 0;
+    }
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) workers.emplace_back([this] { workerLoop(); });
+}
+
+TransferExecutor::~TransferExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+// проверка суммы - в execute, здесь остаётся только остаток отправителя
+void TransferExecutor::run(const Step& s) {
+    if (s.from->withdraw(s.amount)) {
+        s.to->topUp(s.amount);
+        *s.result = TransferStatus::OK;
+    }
+    else {
+        *s.result = TransferStatus::INSUFFICIENT;
+    }
+}
+
+void TransferExecutor::work() {
+    size_t i;
+    while ((i = nextStep.fetch_add(GRAIN, std::memory_order_relaxed)) < stepCount) {
+        size_t end = std::min(i + GRAIN, stepCount);
+        for (; i < end; ++i) run(steps[i]);
+    }
+}
+
+void TransferExecutor::workerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        work();
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (--busy == 0) finished.notify_one();
+        }
+    }
+}
+
+// изменения вкладов потоками видны вызывающему после ожидания под тем же мьютексом
+void TransferExecutor::runParallel(const Step* begin, size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        steps = begin;
+        stepCount = count;
+        nextStep.store(0, std::memory_order_relaxed);
+        busy = workers.size();
+        ++generation;
+    }
+    wake.notify_all();
+    work();
+    std::unique_lock<std::mutex> lock(m);
+    finished.wait(lock, [&] { return busy == 0; });
+}
+
+std::vector<TransferStatus> TransferExecutor::execute(const std::vector<Transfer>& batch) {
+    stats = Stats{};
+    std::vector<TransferStatus> results(batch.size(), TransferStatus::OK);
+    if (lastWave.size() < bank.depositCount()) lastWave.resize(bank.depositCount(), 0);
+
+    // волна перевода - следующая за последней волной любого из двух его вкладов
+    std::vector<uint32_t> waveOf(batch.size(), 0);
+    std::vector<int> src(batch.size(), -1), dst(batch.size(), -1);
+    uint32_t waves = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const Transfer& t = batch[i];
+        if (!validTransferAmount(t.amount)) {
+            results[i] = TransferStatus::BAD_AMOUNT;
+            continue;
+        }
+        int s = bank.depositIndex(t.from);
+        int d = bank.depositIndex(t.to);
+        if (s < 0 || d < 0) {
+            results[i] = TransferStatus::NOT_FOUND;
+            continue;
+        }
+        if (s == d) {
+            results[i] = TransferStatus::SAME_DEPOSIT;
+            continue;
+        }
+        uint32_t w = std::max(lastWave[s], lastWave[d]) + 1;
+        lastWave[s] = lastWave[d] = w;
+        waveOf[i] = w;
+        src[i] = s;
+        dst[i] = d;
+        waves = std::max(waves, w);
+    }
+
+    // переводы по волнам подряд (сортировка подсчётом, порядок внутри волны - как в пакете)
+    std::vector<size_t> start(waves + 2, 0);
+    for (uint32_t w : waveOf) {
+        if (w > 0) ++start[w + 1];
+    }
+    for (size_t w = 1; w < start.size(); ++w) start[w] += start[w - 1];
+    std::vector<Step> plan(start.back());
+    std::vector<size_t> pos(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (waveOf[i] == 0) continue;
+        lastWave[src[i]] = lastWave[dst[i]] = 0;
+        plan[pos[waveOf[i]]++] = Step{ &bank.depositForUpdate(src[i]), &bank.depositForUpdate(dst[i]),
+                                       batch[i].amount, &results[i] };
+    }
+
+    stats.transfers = plan.size();
+    stats.waves = waves;
+    for (uint32_t w = 1; w <= waves; ++w) {
+        const Step* begin = plan.data() + start[w];
+        size_t count = start[w + 1] - start[w];
+        if (count >= PARALLEL_WAVE && !workers.empty()) {
+            runParallel(begin, count);
+            ++stats.parallelWaves;
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) run(begin[i]);
+        }
+    }
+    return results;
+}
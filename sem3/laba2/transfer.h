@@ -0,0 +1,78 @@
+// transfer.h
+#pragma once
+// пакет переводов между вкладами на нескольких потоках.
+//
+//   TransferExecutor exec(bank, 8);
+//   std::vector<TransferStatus> r = exec.execute({ { "1001", "1002", 50.0 }, ... });
+//
+// переводы раскладываются по волнам: в одной волне каждый вклад встречается не больше одного раза,
+// а переводы одного вклада идут по волнам в порядке пакета. поэтому потоки волны не пересекаются
+// и обходятся без блокировок (взаимоблокировке неоткуда взяться), а результат совпадает
+// с Bank::transfer по очереди. волны меньше PARALLEL_WAVE выполняет вызывающий поток.
+// пока идёт execute, банк нельзя трогать из других мест; вызывать - в потоке, который меняет банк
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bank.h"
+
+struct Transfer {
+    std::string from;  // паспорт отправителя
+    std::string to;    // паспорт получателя
+    double amount{ 0.0 };
+};
+
+class TransferExecutor {
+public:
+    struct Stats {
+        size_t transfers{ 0 };      // дошло до волн (остальные отклонены сразу)
+        size_t waves{ 0 };
+        size_t parallelWaves{ 0 };  // выполнено на потоках
+    };
+
+    static constexpr size_t PARALLEL_WAVE = 4096;
+    static constexpr size_t GRAIN = 512; // переводов за один захват работы потоком
+
+private:
+    struct Step {
+        Deposit* from;
+        Deposit* to;
+        double amount;
+        TransferStatus* result;
+    };
+
+    Bank& bank;
+    Stats stats;
+    std::vector<uint32_t> lastWave; // по номеру вклада: последняя волна с ним (0 - не было)
+
+    // текущая волна для потоков
+    std::vector<std::thread> workers;
+    std::mutex m;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    uint64_t generation{ 0 };
+    size_t busy{ 0 };
+    bool stopping{ false };
+    const Step* steps{ nullptr };
+    size_t stepCount{ 0 };
+    std::atomic<size_t> nextStep{ 0 };
+
+    static void run(const Step& s);
+    void work();
+    void workerLoop();
+    void runParallel(const Step* begin, size_t count);
+
+public:
+    // threads - рабочих потоков вдобавок к вызывающему, 0 - по числу ядер
+    explicit TransferExecutor(Bank& bank, size_t threads = 0);
+    ~TransferExecutor();
+    TransferExecutor(const TransferExecutor&) = delete;
+    TransferExecutor& operator=(const TransferExecutor&) = delete;
+
+    // результат каждого перевода по порядку пакета
+    std::vector<TransferStatus> execute(const std::vector<Transfer>& batch);
+    const Stats& lastStats() const { return stats; }
+};
@@ -0,0 +1,266 @@
+// workload.cpp
+#include "workload.h"
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+const char* opTypeToString(OpType t) {
+    switch (t) {
+    case OpType::ADD_CLIENT:   return "client";
+    case OpType::OPEN_DEPOSIT: return "open";
+    case OpType::TOP_UP:       return "topup";
+    case OpType::LOOKUP:       return "lookup";
+    case OpType::INTEREST:     return "interest";
+    case OpType::SET_RATE:     return "rate";
+    default: return "unknown";
+    }
+}
+
+// ГЕНЕРАЦИЯ
+namespace {
+
+// распределение Ципфа на 1..n методом rejection-inversion (Hörmann, Derflinger),
+// без таблицы на n элементов - n может расти по мере появления клиентов
+class ZipfSampler {
+private:
+    double exponent;
+    uint32_t n{ 0 };
+    double hX1{ 0 }, hN{ 0 }, s{ 0 };
+
+    static double helper1(double x) {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+    }
+    static double helper2(double x) {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+    }
+    double h(double x) const { return std::exp(-exponent * std::log(x)); }
+    double hIntegral(double x) const {
+        double logX = std::log(x);
+        return helper2((1 - exponent) * logX) * logX;
+    }
+    double hIntegralInverse(double x) const {
+        double t = std::max(x * (1 - exponent), -1.0);
+        return std::exp(helper1(t) * x);
+    }
+
+public:
+    explicit ZipfSampler(double exponent) : exponent(exponent) {}
+
+    void resize(uint32_t count) {
+        n = count;
+        hX1 = hIntegral(1.5) - 1;
+        hN = hIntegral(n + 0.5);
+        s = 2 - hIntegralInverse(hIntegral(2.5) - h(2));
+    }
+
+    // ранг 0..n-1, 0 - самый частый
+    template <class Rng>
+    uint32_t operator()(Rng& rng) {
+        if (exponent <= 0) return std::uniform_int_distribution<uint32_t>(0, n - 1)(rng);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        while (true) {
+            double u = hN + uniform(rng) * (hX1 - hN);
+            double x = hIntegralInverse(u);
+            double k = std::clamp(std::floor(x + 0.5), 1.0, double(n));
+            if (k - x <= s || u >= hIntegral(k + 0.5) - h(k)) return static_cast<uint32_t>(k) - 1;
+        }
+    }
+};
+
+std::string passportOf(uint32_t client) {
+    return std::to_string(1000000000ull + client);
+}
+
+} // namespace
+
+size_t generateWorkload(const WorkloadConfig& config, std::ostream& out) {
+    std::mt19937_64 rng(config.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::discrete_distribution<int> kindDist(config.kindWeights, config.kindWeights + 3);
+    std::lognormal_distribution<double> depositDist(std::log(config.depositMedian), config.depositSigma);
+    std::lognormal_distribution<double> topUpDist(std::log(config.topUpMedian), config.topUpSigma);
+    std::discrete_distribution<int> opDist({ config.topUpWeight, config.lookupWeight, config.newClientWeight,
+                                             config.interestWeight, config.rateWeight });
+
+    // ранг Ципфа -> клиент; новый клиент встаёт на случайное место, чтобы горячими были не только первые
+    std::vector<uint32_t> byRank;
+    ZipfSampler zipf(config.zipf);
+    size_t written = 0;
+
+    out << "# bank workload seed=" << config.seed << " clients=" << config.clients
+        << " operations=" << config.operations << " zipf=" << config.zipf << "\n";
+    out.setf(std::ios::fixed);
+    out.precision(2);
+
+    auto addClient = [&](bool withDeposit) {
+        uint32_t c = static_cast<uint32_t>(byRank.size());
+        std::string passport = passportOf(c);
+        out << "client;" << passport << ";client" << c << "\n";
+        ++written;
+        if (withDeposit) {
+            out << "open;" << passport << ';' << kindDist(rng) + 1 << ';' << std::max(1.0, depositDist(rng)) << "\n";
+            ++written;
+        }
+        byRank.push_back(c);
+        std::swap(byRank.back(), byRank[std::uniform_int_distribution<size_t>(0, c)(rng)]);
+        zipf.resize(static_cast<uint32_t>(byRank.size()));
+    };
+
+    for (uint32_t i = 0; i < config.clients; ++i) addClient(uniform(rng) < config.depositShare);
+
+    for (size_t i = 0; i < config.operations; ++i) {
+        int op = opDist(rng);
+        if (byRank.empty() && op != 2) op = 2;
+        switch (op) {
+        case 0:
+            out << "topup;" << passportOf(byRank[zipf(rng)]) << ';' << std::max(1.0, topUpDist(rng)) << "\n";
+            ++written;
+            break;
+        case 1:
+            out << "lookup;" << passportOf(byRank[zipf(rng)]) << "\n";
+            ++written;
+            break;
+        case 2:
+            addClient(true);
+            break;
+        case 3:
+            out << "interest\n";
+            ++written;
+            break;
+        default: {
+            // ставка от 1% до 15% с шагом 0.25%
+            int quarter = std::uniform_int_distribution<int>(4, 60)(rng);
+            out.precision(4);
+            out << "rate;" << kindDist(rng) + 1 << ';' << quarter * 0.0025 << "\n";
+            out.precision(2);
+            ++written;
+            break;
+        }
+        }
+    }
+    return written;
+}
+
+// ЧТЕНИЕ
+namespace {
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t pos = line.find(';', start);
+        fields.push_back(line.substr(start, pos - start));
+        if (pos == std::string::npos) break;
+        start = pos + 1;
+    }
+    return fields;
+}
+
+double parseNumber(const std::string& s, size_t line) {
+    size_t used = 0;
+    double v = 0.0;
+    try {
+        v = std::stod(s, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != s.size() || !std::isfinite(v))
+        throw std::runtime_error("строка " + std::to_string(line) + ": не число '" + s + "'");
+    return v;
+}
+
+DepositKind parseKind(const std::string& s, size_t line) {
+    if (s != "1" && s != "2" && s != "3")
+        throw std::runtime_error("строка " + std::to_string(line) + ": тип вклада должен быть 1-3");
+    return static_cast<DepositKind>(s[0] - '0');
+}
+
+} // namespace
+
+Workload readWorkload(std::istream& in) {
+    Workload w;
+    std::unordered_map<std::string, uint32_t> clientOf;
+    // номер клиента по паспорту; паспорт без строки client получает пустое имя
+    auto clientIndex = [&](const std::string& passport) {
+        auto [it, added] = clientOf.emplace(passport, static_cast<uint32_t>(w.passports.size()));
+        if (added) {
+            w.passports.push_back(passport);
+            w.names.emplace_back();
+        }
+        return it->second;
+    };
+
+    std::string line;
+    size_t lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        std::vector<std::string> f = splitFields(line);
+        const std::string& cmd = f[0];
+        Operation op;
+        size_t expected = 0;
+        if (cmd == "client") {
+            op.type = OpType::ADD_CLIENT;
+            expected = 3;
+        }
+        else if (cmd == "open") {
+            op.type = OpType::OPEN_DEPOSIT;
+            expected = 4;
+        }
+        else if (cmd == "topup") {
+            op.type = OpType::TOP_UP;
+            expected = 3;
+        }
+        else if (cmd == "lookup") {
+            op.type = OpType::LOOKUP;
+            expected = 2;
+        }
+        else if (cmd == "interest") {
+            op.type = OpType::INTEREST;
+            expected = 1;
+        }
+        else if (cmd == "rate") {
+            op.type = OpType::SET_RATE;
+            expected = 3;
+        }
+        else {
+            throw std::runtime_error("строка " + std::to_string(lineNo) + ": неизвестная операция '" + cmd + "'");
+        }
+        if (f.size() != expected)
+            throw std::runtime_error("строка " + std::to_string(lineNo) + ": ожидалось полей: " + std::to_string(expected));
+
+        switch (op.type) {
+        case OpType::ADD_CLIENT:
+            op.client = clientIndex(f[1]);
+            w.names[op.client] = f[2];
+            break;
+        case OpType::OPEN_DEPOSIT:
+            op.client = clientIndex(f[1]);
+            op.kind = parseKind(f[2], lineNo);
+            op.value = parseNumber(f[3], lineNo);
+            break;
+        case OpType::TOP_UP:
+            op.client = clientIndex(f[1]);
+            op.value = parseNumber(f[2], lineNo);
+            break;
+        case OpType::LOOKUP:
+            op.client = clientIndex(f[1]);
+            break;
+        case OpType::SET_RATE:
+            op.kind = parseKind(f[1], lineNo);
+            op.value = parseNumber(f[2], lineNo);
+            break;
+        default:
+            break;
+        }
+        w.ops.push_back(op);
+    }
+    return w;
+}
@@ -0,0 +1,73 @@
+// workload.h
+#pragma once
+// синтетическая нагрузка для банка: клиенты, вклады, пополнения, запросы и смена ставок.
+// поток полностью определяется настройками и seed (распределения - из стандартной библиотеки,
+// так что между разными компиляторами потоки отличаются), его можно записать в файл и
+// воспроизвести сколько угодно раз (bank_workload пишет файл, bank_replay его проигрывает).
+//
+// формат файла - по операции в строке, поля через ';', строки с '#' - комментарии:
+//   client;<паспорт>;<имя>        topup;<паспорт>;<сумма>      interest
+//   open;<паспорт>;<тип 1-3>;<сумма>  lookup;<паспорт>          rate;<тип 1-3>;<ставка в долях>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "bank.h"
+
+enum class OpType {
+    ADD_CLIENT,
+    OPEN_DEPOSIT,
+    TOP_UP,
+    LOOKUP,
+    INTEREST,
+    SET_RATE,
+    COUNT
+};
+
+const char* opTypeToString(OpType t);
+
+struct Operation {
+    OpType type{ OpType::LOOKUP };
+    uint32_t client{ 0 };              // номер в Workload::passports/names
+    DepositKind kind{ DepositKind::FIXED };
+    double value{ 0.0 };               // сумма вклада/пополнения или ставка
+};
+
+// прочитанный файл нагрузки: паспорта и имена хранятся один раз, операции ссылаются на них по номеру
+struct Workload {
+    std::vector<std::string> passports;
+    std::vector<std::string> names;
+    std::vector<Operation> ops;
+};
+
+struct WorkloadConfig {
+    uint64_t seed{ 1 };
+    uint32_t clients{ 10000 };         // клиентов в начальном заселении
+    double depositShare{ 0.8 };        // доля клиентов, которые сразу открывают вклад
+    size_t operations{ 100000 };       // операций после заселения
+
+    // показатель распределения Ципфа для выбора клиента: 0 - равномерно, ~1 - горячие счета
+    double zipf{ 0.99 };
+
+    // относительные веса операций после заселения (новый клиент идёт вместе с открытием вклада)
+    double topUpWeight{ 60.0 };
+    double lookupWeight{ 35.0 };
+    double newClientWeight{ 4.0 };
+    double interestWeight{ 0.9 };
+    double rateWeight{ 0.1 };
+
+    // веса типов вкладов: срочный, накопительный, долгосрочный
+    double kindWeights[3]{ 1.0, 2.0, 1.0 };
+
+    // суммы логнормальные: медиана и сигма логарифма
+    double depositMedian{ 50000.0 };
+    double depositSigma{ 1.0 };
+    double topUpMedian{ 5000.0 };
+    double topUpSigma{ 0.8 };
+};
+
+// пишет поток операций в out, возвращает число записанных операций
+size_t generateWorkload(const WorkloadConfig& config, std::ostream& out);
+
+// бросает std::runtime_error с номером строки, если файл испорчен
+Workload readWorkload(std::istream& in);
@@ -0,0 +1,100 @@
+// workload_main.cpp
+// генератор нагрузки: bank_workload [параметры] > нагрузка.txt
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "workload.h"
+
+static void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "использование: %s [--seed N] [--clients N] [--deposit-share 0..1] [--ops N] [--zipf S]\n"
+        "               [--mix topup,lookup,newclient,interest,rate] [--kinds срочный,накопительный,долгосрочный]\n"
+        "               [--deposit медиана,сигма] [--topup медиана,сигма] [--out файл]\n",
+        program);
+}
+
+// "a,b,c" -> count неотрицательных чисел
+static bool parseList(const std::string& text, double* values, size_t count) {
+    std::stringstream ss(text);
+    std::string item;
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::getline(ss, item, ',')) return false;
+        char* end = nullptr;
+        values[i] = std::strtod(item.c_str(), &end);
+        if (item.empty() || *end != '\0' || values[i] < 0) return false;
+    }
+    return !std::getline(ss, item, ',');
+}
+
+static bool parseCount(const std::string& text, unsigned long long& value) {
+    char* end = nullptr;
+    value = std::strtoull(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0';
+}
+
+int main(int argc, char** argv) {
+    WorkloadConfig config;
+    std::string outFile;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        unsigned long long n = 0;
+        double pair[2] = { 0, 0 };
+        double mix[5] = { 0, 0, 0, 0, 0 };
+        bool ok = true;
+        if (arg == "--seed" && (ok = parseCount(value, n))) config.seed = n;
+        else if (arg == "--clients" && (ok = parseCount(value, n) && n <= 0xFFFFFFFFull)) config.clients = static_cast<uint32_t>(n);
+        else if (arg == "--ops" && (ok = parseCount(value, n))) config.operations = static_cast<size_t>(n);
+        else if (arg == "--deposit-share" && (ok = parseList(value, pair, 1) && pair[0] <= 1)) config.depositShare = pair[0];
+        else if (arg == "--zipf" && (ok = parseList(value, pair, 1))) config.zipf = pair[0];
+        else if (arg == "--mix" && (ok = parseList(value, mix, 5))) {
+            config.topUpWeight = mix[0];
+            config.lookupWeight = mix[1];
+            config.newClientWeight = mix[2];
+            config.interestWeight = mix[3];
+            config.rateWeight = mix[4];
+            ok = mix[0] + mix[1] + mix[2] + mix[3] + mix[4] > 0;
+        }
+        else if (arg == "--kinds") ok = parseList(value, config.kindWeights, 3) &&
+            config.kindWeights[0] + config.kindWeights[1] + config.kindWeights[2] > 0;
+        else if (arg == "--deposit" && (ok = parseList(value, pair, 2) && pair[0] > 0)) {
+            config.depositMedian = pair[0];
+            config.depositSigma = pair[1];
+        }
+        else if (arg == "--topup" && (ok = parseList(value, pair, 2) && pair[0] > 0)) {
+            config.topUpMedian = pair[0];
+            config.topUpSigma = pair[1];
+        }
+        else if (arg == "--out") outFile = value;
+        else ok = false;
+
+        if (!ok) {
+            std::fprintf(stderr, "неверное значение %s: %s\n", arg.c_str(), value.c_str());
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    size_t written = 0;
+    if (outFile.empty()) {
+        written = generateWorkload(config, std::cout);
+    }
+    else {
+        std::ofstream out(outFile);
+        written = generateWorkload(config, out);
+        if (!out) {
+            std::fprintf(stderr, "не удалось записать %s\n", outFile.c_str());
+            return 1;
+        }
+    }
+    std::fprintf(stderr, "операций: %zu\n", written);
+    return 0;
+}
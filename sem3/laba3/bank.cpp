@@ -2,8 +2,16 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <stdexcept>
 #include <cctype>   
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <map>
+#include <cmath>
+#include <limits>
 
 class BonusStrategy {
 public:
@@ -69,14 +77,89 @@ public:
     }
 };
 
+// статистика по суммам вкладов, обновляется при каждом добавлении.
+// перцентили приближённые: логарифмическая гистограмма с точностью ~1%
+class AmountStats {
+private:
+    static constexpr double gamma = 1.02; // соседние корзины отличаются на 2%
+
+    size_t count = 0;
+    double sum = 0.0;
+    double minValue = std::numeric_limits<double>::infinity();
+    double maxValue = -std::numeric_limits<double>::infinity();
+    double mean = 0.0;
+    double m2 = 0.0;               // сумма квадратов отклонений (Уэлфорд)
+    size_t zeroCount = 0;          // нулевые суммы в отдельной корзине
+    std::map<int, size_t> buckets; // номер корзины -> количество
+
+    static int bucketOf(double v) {
+        return static_cast<int>(std::ceil(std::log(v) / std::log(gamma)));
+    }
+
+    // середина корзины (относительная ошибка не больше (gamma-1)/2)
+    static double bucketValue(int idx) {
+        return 2.0 * std::pow(gamma, idx) / (gamma + 1.0);
+    }
+
+public:
+    void add(double v) {
+        ++count;
+        sum += v;
+        minValue = std::min(minValue, v);
+        maxValue = std::max(maxValue, v);
+
+        double delta = v - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (v - mean);
+
+        if (v > 0) ++buckets[bucketOf(v)];
+        else ++zeroCount;
+    }
+
+    size_t getCount() const { return count; }
+    double getSum() const { return sum; }
+    double getMin() const { return count ? minValue : 0.0; }
+    double getMax() const { return count ? maxValue : 0.0; }
+    double getMean() const { return mean; }
+    double getVariance() const { return count ? m2 / static_cast<double>(count) : 0.0; }
+
+    // q от 0 до 1, например 0.95
+    double getPercentile(double q) const {
+        if (count == 0) return 0.0;
+        q = std::min(std::max(q, 0.0), 1.0);
+        size_t rank = static_cast<size_t>(q * static_cast<double>(count - 1));
+
+        if (rank < zeroCount) return 0.0;
+        size_t seen = zeroCount;
+        for (const auto& b : buckets) {
+            seen += b.second;
+            if (rank < seen) {
+                return std::min(std::max(bucketValue(b.first), getMin()), getMax());
+            }
+        }
+        return getMax();
+    }
+};
+
 // банк
 class Bank {
 private:
     std::vector<Depositor> depositors; 
+    AmountStats stats;
 
 public:
     void addDepositor(const Depositor& d) {
         depositors.push_back(d);
+        stats.add(d.getAmount());
+    }
+
+    // добавить сразу пачку (порядок сохраняется)
+    void addDepositors(std::vector<Depositor>&& batch) {
+        depositors.reserve(depositors.size() + batch.size());
+        for (auto& d : batch) {
+            stats.add(d.getAmount());
+            depositors.push_back(std::move(d));
+        }
     }
 
     double getTotal() const {
@@ -87,6 +170,27 @@ public:
         return sum;
     }
 
+    const AmountStats& getStats() const {
+        return stats;
+    }
+
+    void printStats() const {
+        if (stats.getCount() == 0) {
+            std::cout << "в банке пока нет вкладчиков.\n";
+            return;
+        }
+        std::cout << "статистика по вкладам:\n"
+            << "количество: " << stats.getCount() << "\n"
+            << "сумма: " << stats.getSum() << "\n"
+            << "минимум: " << stats.getMin() << "\n"
+            << "максимум: " << stats.getMax() << "\n"
+            << "среднее: " << stats.getMean() << "\n"
+            << "дисперсия: " << stats.getVariance() << "\n"
+            << "p50: " << stats.getPercentile(0.50) << "\n"
+            << "p95: " << stats.getPercentile(0.95) << "\n"
+            << "p99: " << stats.getPercentile(0.99) << "\n";
+    }
+
     void printAll() const {
         if (depositors.empty()) {
             std::cout << "в банке пока нет вкладчиков.\n";
@@ -102,30 +206,63 @@ public:
 
 // безопаснsq ввод
 
-//корректное число 
-bool isValidNumberString(const std::string& s) {
-    bool hasDot = false;
-    if (s.empty()) return false;
+// результат разбора числа (без исключений)
+enum class ParseError {
+    Ok,
+    NotANumber,  // пустая строка, буквы, лишние знаки
+    OutOfRange   // число не помещается в тип
+};
+
+// правила как раньше: необязательный знак, цифры и не больше одной точки.
+// проверка и разбор за один проход через from_chars
+ParseError parseDouble(std::string_view s, double& out) {
+    size_t start = 0;
+    if (!s.empty() && (s[0] == '+' || s[0] == '-')) {
+        start = 1;
+    }
+    // после знака - только цифра или точка (отсекаем inf, nan, "+-1")
+    if (start >= s.size() ||
+        !(s[start] == '.' || std::isdigit(static_cast<unsigned char>(s[start])))) {
+        return ParseError::NotANumber;
+    }
 
+    // from_chars не принимает '+', поэтому пропускаем его сами
+    const char* first = s.data() + (s[0] == '+' ? 1 : 0);
+    const char* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(first, last, out, std::chars_format::fixed);
+
+    if (ec == std::errc::result_out_of_range) return ParseError::OutOfRange;
+    if (ec != std::errc() || ptr != last) return ParseError::NotANumber;
+    return ParseError::Ok;
+}
+
+// как std::stoi раньше: дробная часть допускается и отбрасывается
+ParseError parseInt(std::string_view s, int& out) {
     size_t start = 0;
-    if (s[0] == '+' || s[0] == '-') {
-        if (s.size() == 1) return false; 
+    if (!s.empty() && (s[0] == '+' || s[0] == '-')) {
         start = 1;
     }
+    if (start >= s.size() || !std::isdigit(static_cast<unsigned char>(s[start]))) {
+        return ParseError::NotANumber;
+    }
+
+    const char* first = s.data() + (s[0] == '+' ? 1 : 0);
+    const char* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(first, last, out);
+
+    if (ec == std::errc::result_out_of_range) return ParseError::OutOfRange;
+    if (ec != std::errc()) return ParseError::NotANumber;
 
-    for (size_t i = start; i < s.size(); ++i) {
-        if (s[i] == '.') {
-            if (hasDot) {
-                return false;
+    // хвост: либо ничего, либо точка и цифры
+    if (ptr != last) {
+        if (*ptr != '.') return ParseError::NotANumber;
+        for (++ptr; ptr != last; ++ptr) {
+            if (!std::isdigit(static_cast<unsigned char>(*ptr))) {
+                return ParseError::NotANumber;
             }
-            hasDot = true;
-        }
-        else if (!std::isdigit(static_cast<unsigned char>(s[i]))) {
-            return false;
         }
     }
-
-    return true;
+    return ParseError::Ok;
 }
 
 //буквы и лишние символы
@@ -135,23 +272,23 @@ double readDouble(const std::string& prompt) {
         std::string input;
         std::getline(std::cin, input);
 
-        try {
-            if (!isValidNumberString(input)) {
-                throw std::invalid_argument("введено нечисловое значение.");
-            }
-            double value = std::stod(input);
-            if (value < 0) {
-                throw std::invalid_argument("сумма не может быть отрицательной.");
-            }
-            return value;
-        }
-        catch (const std::invalid_argument& e) {
-            std::cout << "ошибка: " << e.what()
+        double value = 0.0;
+        ParseError err = parseDouble(input, value);
+
+        if (err == ParseError::NotANumber) {
+            std::cout << "ошибка: введено нечисловое значение."
                 << " попробуйте ещё раз.\n\n";
         }
-        catch (const std::out_of_range&) {
+        else if (err == ParseError::OutOfRange) {
             std::cout << "слишком большое число, попробуйте ещё раз.\n\n";
         }
+        else if (value < 0) {
+            std::cout << "ошибка: сумма не может быть отрицательной."
+                << " попробуйте ещё раз.\n\n";
+        }
+        else {
+            return value;
+        }
     }
 }
 
@@ -161,30 +298,151 @@ int readInt(const std::string& prompt, int minValue, int maxValue) {
         std::string input;
         std::getline(std::cin, input);
 
-        try {
-            if (!isValidNumberString(input)) {
-                throw std::invalid_argument("введено нецелое число.");
-            }
-            int value = std::stoi(input);
-
-            if (value < minValue || value > maxValue) {
-                throw std::out_of_range("число вне допустимого диапазона.");
-            }
+        int value = 0;
+        ParseError err = parseInt(input, value);
 
-            return value;
-        }
-        catch (const std::invalid_argument& e) {
-            std::cout << "ошибка: " << e.what()
+        if (err == ParseError::NotANumber) {
+            std::cout << "ошибка: введено нецелое число."
                 << " попробуйте ещё раз.\n\n";
         }
-        catch (const std::out_of_range& e) {
-            std::cout << "ошибка: " << e.what()
+        else if (err == ParseError::OutOfRange || value < minValue || value > maxValue) {
+            std::cout << "ошибка: число вне допустимого диапазона."
                 << " допустимый диапазон: от "
                 << minValue << " до " << maxValue << ".\n\n";
         }
+        else {
+            return value;
+        }
+    }
+}
+
+//  загрузка из файла
+// формат строки: имя;сумма;тип бонуса (1 - без бонуса, 2 - фиксированный)
+
+struct LoadResult {
+    size_t loaded = 0;
+    size_t rejected = 0;
+    size_t firstBadLine = 0; // номер первой плохой строки (с 1), 0 - таких нет
+    bool opened = true;
+    bool readError = false;  // файл открылся, но прочитать его целиком не удалось
+};
+
+// результат разбора одного куска файла
+struct ChunkResult {
+    std::vector<Depositor> depositors;
+    size_t lines = 0;
+    size_t rejected = 0;
+    size_t firstBadLine = 0; // номер внутри куска (с 1)
+};
+
+bool parseDepositorLine(std::string_view line, std::vector<Depositor>& out) {
+    static const NoBonusStrategy noBonus;
+    static const FixedBonusStrategy fixedBonus(500.0);
+
+    size_t p1 = line.find(';');
+    if (p1 == std::string_view::npos || p1 == 0) return false;
+    size_t p2 = line.find(';', p1 + 1);
+    if (p2 == std::string_view::npos) return false;
+
+    double amount = 0.0;
+    int bonus = 0;
+    if (parseDouble(line.substr(p1 + 1, p2 - p1 - 1), amount) != ParseError::Ok || amount < 0) {
+        return false;
+    }
+    if (parseInt(line.substr(p2 + 1), bonus) != ParseError::Ok || bonus < 1 || bonus > 2) {
+        return false;
+    }
+
+    const BonusStrategy& strategy = (bonus == 1)
+        ? static_cast<const BonusStrategy&>(noBonus)
+        : static_cast<const BonusStrategy&>(fixedBonus);
+    out.emplace_back(std::string(line.substr(0, p1)), amount, strategy);
+    return true;
+}
+
+void parseChunk(std::string_view chunk, ChunkResult& res) {
+    size_t pos = 0;
+    while (pos < chunk.size()) {
+        size_t eol = chunk.find('\n', pos);
+        if (eol == std::string_view::npos) eol = chunk.size();
+
+        std::string_view line = chunk.substr(pos, eol - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        ++res.lines;
+
+        if (!line.empty() && !parseDepositorLine(line, res.depositors)) {
+            ++res.rejected;
+            if (res.firstBadLine == 0) res.firstBadLine = res.lines;
+        }
+        pos = eol + 1;
     }
 }
 
+// файл читается целиком, режется на куски по границам строк,
+// куски разбираются в нескольких потоках и добавляются в банк по порядку
+LoadResult loadDepositorsFromFile(const std::string& path, Bank& bank) {
+    LoadResult result;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        result.opened = false;
+        return result;
+    }
+    // tellg возвращает -1, если размер узнать нельзя, а для каталога - заведомо лишний размер
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    std::string data;
+    if (!in || size < 0 || static_cast<unsigned long long>(size) > data.max_size()) {
+        result.readError = true;
+        return result;
+    }
+    data.resize(static_cast<size_t>(size));
+    in.seekg(0, std::ios::beg);
+    in.read(&data[0], static_cast<std::streamsize>(data.size()));
+    if (in.gcount() != static_cast<std::streamsize>(data.size())) {
+        result.readError = true;
+        return result;
+    }
+
+    const size_t minChunk = 1 << 20; // мелкие файлы не дробим
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<size_t>(1, data.size() / minChunk));
+
+    // границы кусков сдвигаем до ближайшего '\n'
+    std::vector<std::string_view> chunks;
+    std::string_view all(data);
+    size_t begin = 0;
+    for (size_t i = 1; i <= threads && begin < all.size(); ++i) {
+        size_t end = all.size();
+        if (i < threads) {
+            end = all.find('\n', std::max(begin, all.size() * i / threads));
+            end = (end == std::string_view::npos) ? all.size() : end + 1;
+        }
+        chunks.push_back(all.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<ChunkResult> parts(chunks.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back(parseChunk, chunks[i], std::ref(parts[i]));
+    }
+    if (!chunks.empty()) parseChunk(chunks[0], parts[0]);
+    for (auto& t : workers) t.join();
+
+    size_t lineOffset = 0;
+    for (auto& part : parts) {
+        result.loaded += part.depositors.size();
+        result.rejected += part.rejected;
+        if (result.firstBadLine == 0 && part.firstBadLine != 0) {
+            result.firstBadLine = lineOffset + part.firstBadLine;
+        }
+        lineOffset += part.lines;
+        bank.addDepositors(std::move(part.depositors));
+    }
+    return result;
+}
+
 //  меню
 
 void printMenu() {
@@ -192,6 +450,8 @@ void printMenu() {
         << "1. добавить вкладчика\n"
         << "2. показать всех вкладчиков\n"
         << "3. показать общую сумму вкладов\n"
+        << "4. загрузить вкладчиков из файла\n"
+        << "5. статистика по вкладам\n"
         << "0. выход\n";
 }
 
@@ -201,7 +461,7 @@ int main() {
 
     while (true) {
         printMenu();
-        int choice = readInt("ваш выбор: ", 0, 3);
+        int choice = readInt("ваш выбор: ", 0, 5);
 
         if (choice == 0) {
             std::cout << "выход из программы.\n";
@@ -247,6 +507,29 @@ int main() {
             double total = bank.getTotal();
             std::cout << "общая сумма вкладов: " << total << "\n";
         }
+        else if (choice == 4) {
+            std::cout << "введите путь к файлу: ";
+            std::string path;
+            std::getline(std::cin, path);
+
+            LoadResult res = loadDepositorsFromFile(path, bank);
+            if (!res.opened) {
+                std::cout << "не удалось открыть файл.\n";
+            }
+            else if (res.readError) {
+                std::cout << "ошибка чтения файла.\n";
+            }
+            else {
+                std::cout << "загружено вкладчиков: " << res.loaded << "\n";
+                if (res.rejected > 0) {
+                    std::cout << "пропущено строк с ошибками: " << res.rejected
+                        << " (первая - строка " << res.firstBadLine << ")\n";
+                }
+            }
+        }
+        else if (choice == 5) {
+            bank.printStats();
+        }
     }
 
     return 0;
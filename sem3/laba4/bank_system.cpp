@@ -1,66 +1,174 @@
 // BankSystem.cpp
 #include "BankSystem.h"
+#include "../bank_core/columnar.h"
+#include <string>
+#include <stdexcept>
+
+static std::string StringToUTF8(String^ str) {
+    if (String::IsNullOrEmpty(str)) return "";
+    array<Byte>^ bytes = Encoding::UTF8->GetBytes(str);
+    pin_ptr<Byte> pinned = &bytes[0];
+    return std::string((char*)pinned, bytes->Length);
+}
+
+static String^ UTF8ToString(const std::string& utf8) {
+    if (utf8.empty()) return "";
+    return gcnew String(utf8.data(), 0, (int)utf8.size(), Encoding::UTF8);
+}
+
+static core::ClientRecord ToNative(Client^ c) {
+    core::ClientRecord r;
+    r.name = StringToUTF8(c->Name);
+    r.rate = c->Rate;
+    r.vip = c->IsVIP();
+    r.amount = r.vip ? c->Amount - core::ClientRecord::VipBonus : c->Amount;
+    return r;
+}
+
+static Client^ FromNative(const core::ClientRecord& r) {
+    String^ name = UTF8ToString(r.name);
+    if (r.vip)
+        return gcnew VIPClient(name, r.rate, r.amount);
+    return gcnew SimpleClient(name, r.rate, r.amount);
+}
+
+// .bcol - колоночный формат ядра, остальное - основной формат лабы
+static bool IsColumnarFile(String^ filename) {
+    return filename->EndsWith(".bcol", StringComparison::OrdinalIgnoreCase);
+}
 
 BankSystem::BankSystem() {
-    clients = gcnew List<Client^>();
+    native = new core::BankSystem();
+    view = new core::ClientViewModel(*native);
+    names = new core::NameIndex(*native);
+    view->SetDecimalSeparator(StringToUTF8(
+        System::Globalization::CultureInfo::CurrentCulture->NumberFormat->NumberDecimalSeparator));
+}
+
+BankSystem::~BankSystem() {
+    this->!BankSystem();
+}
+
+BankSystem::!BankSystem() {
+    delete names;
+    delete view;
+    delete native;
+    names = nullptr;
+    view = nullptr;
+    native = nullptr;
 }
 
 void BankSystem::AddClient(Client^ c) {
-    if (c != nullptr) clients->Add(c);
+    if (c != nullptr) native->AddClient(ToNative(c));
 }
 
 void BankSystem::RemoveClient(int index) {
-    if (index >= 0 && index < clients->Count)
-        clients->RemoveAt(index);
+    native->RemoveClient(index);
 }
 
 void BankSystem::UpdateClient(int index, Client^ c) {
-    if (index >= 0 && index < clients->Count && c != nullptr)
-        clients[index] = c;
+    if (c != nullptr) native->UpdateClient(index, ToNative(c));
+}
+
+int BankSystem::Count() {
+    return native->Count();
+}
+
+Client^ BankSystem::GetClient(int index) {
+    if (index < 0 || index >= native->Count()) return nullptr;
+    return FromNative(native->GetClient(index));
 }
 
 List<Client^>^ BankSystem::GetClients() {
-    return clients;
+    List<Client^>^ list = gcnew List<Client^>(native->Count());
+    for (const auto& r : native->GetClients()) {
+        list->Add(FromNative(r));
+    }
+    return list;
 }
 
+// итог ведёт модель представления, пересчёт всех клиентов не нужен
 double BankSystem::CalculateTotalIncome() {
-    double total = 0.0;
-    for each (Client ^ c in clients) {
-        total += c->Calculate();
+    return view->TotalIncome();
+}
+
+int BankSystem::FindFirstByPrefix(String^ prefix) {
+    if (String::IsNullOrWhiteSpace(prefix)) return -1;
+    std::vector<core::ClientHandle> found = names->FindPrefix(StringToUTF8(prefix->Trim()), 1);
+    return found.empty() ? -1 : native->IndexOf(found[0]);
+}
+
+String^ BankSystem::GetCell(int row, int column) {
+    return UTF8ToString(view->GetCell(row, column));
+}
+
+String^ BankSystem::FormatTotalIncome() {
+    return UTF8ToString(view->FormatTotalIncome());
+}
+
+List<RowChange>^ BankSystem::TakeChanges() {
+    List<RowChange>^ list = gcnew List<RowChange>();
+    for (const auto& ch : view->TakeChanges()) {
+        RowChange rc;
+        rc.Index = ch.index;
+        switch (ch.kind) {
+        case core::RowChangeKind::Inserted: rc.Kind = RowChangeKind::Inserted; break;
+        case core::RowChangeKind::Updated:  rc.Kind = RowChangeKind::Updated; break;
+        case core::RowChangeKind::Removed:  rc.Kind = RowChangeKind::Removed; break;
+        default:                            rc.Kind = RowChangeKind::Reset; break;
+        }
+        list->Add(rc);
     }
-    return total;
+    return list;
+}
+
+void BankSystem::SortByName() {
+    native->SortByName();
 }
 
+void BankSystem::SortByColumn(String^ column, bool descending) {
+    core::SortField field = core::SortField::Name;
+    if (column == "Type") field = core::SortField::Type;
+    else if (column == "Rate") field = core::SortField::Rate;
+    else if (column == "Amount") field = core::SortField::Amount;
+    else if (column == "Income") field = core::SortField::Income;
+
+    std::vector<core::SortKey> keys;
+    keys.push_back({ field, descending });
+    if (field != core::SortField::Name)
+        keys.push_back({ core::SortField::Name, false });
+    native->Sort(keys);
+}
+
+// ошибки ядра приходят как std::exception, формы ловят Exception^
 void BankSystem::SaveToFile(String^ filename) {
-    StreamWriter^ sw = gcnew StreamWriter(filename, false, Encoding::UTF8);
-    for each (Client ^ c in clients) {
-        sw->WriteLine("{0},{1},{2},{3}",
-            c->IsVIP() ? "VIP" : "Simple",
-            c->Name,
-            c->Rate,
-            c->IsVIP() ? c->Amount - 1000 : c->Amount
-        );
+    bool columnar = IsColumnarFile(filename);
+    std::string path = StringToUTF8(filename);
+    std::string error;
+    try {
+        if (columnar)
+            core::SaveToColumnar(*native, path);
+        else
+            native->SaveToFile(path);
+    }
+    catch (const std::exception& e) {
+        error = e.what();
     }
-    sw->Close();
+    if (!error.empty()) throw gcnew Exception(UTF8ToString(error));
 }
 
 void BankSystem::LoadFromFile(String^ filename) {
-    clients->Clear();
-    StreamReader^ sr = gcnew StreamReader(filename, Encoding::UTF8);
-    String^ line;
-    while ((line = sr->ReadLine()) != nullptr) {
-        array<String^>^ parts = line->Split(',');
-        if (parts->Length == 4) {
-            bool isVIP = (parts[0] == "VIP");
-            String^ name = parts[1];
-            int rate, amount;
-            if (Int32::TryParse(parts[2], rate) && Int32::TryParse(parts[3], amount)) {
-                if (isVIP)
-                    AddClient(gcnew VIPClient(name, rate, amount));
-                else
-                    AddClient(gcnew SimpleClient(name, rate, amount));
-            }
-        }
+    bool columnar = IsColumnarFile(filename);
+    std::string path = StringToUTF8(filename);
+    std::string error;
+    try {
+        if (columnar)
+            core::LoadFromColumnar(*native, path);
+        else
+            native->LoadFromFile(path);
+    }
+    catch (const std::exception& e) {
+        error = e.what();
     }
-    sr->Close();
+    if (!error.empty()) throw gcnew Exception(UTF8ToString(error));
 }
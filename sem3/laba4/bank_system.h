@@ -2,22 +2,50 @@
 // BankSystem.h
 #pragma once
 #include "Client.h"
+#include "../bank_core/bank_core.h"
+#include "../bank_core/name_index.h"
+#include "../bank_core/view_model.h"
 using namespace System;
 using namespace System::Collections::Generic;
 using namespace System::IO;
 using namespace System::Text;
 
+// изменения строк таблицы после операций с BankSystem (см. core::RowChange)
+public enum class RowChangeKind { Inserted, Updated, Removed, Reset };
+
+public value struct RowChange {
+    RowChangeKind Kind;
+    int Index;
+};
+
+// обёртка над переносимым ядром core::BankSystem (папка bank_core)
 ref class BankSystem {
 private:
-    List<Client^>^ clients;
+    core::BankSystem* native;
+    core::ClientViewModel* view; // строки для таблицы в виртуальном режиме
+    core::NameIndex* names; // поиск клиента по началу имени
 
 public:
     BankSystem();
+    ~BankSystem();
+    !BankSystem();
     void AddClient(Client^ c);
     void RemoveClient(int index);
     void UpdateClient(int index, Client^ c);
-    List<Client^>^ GetClients();
+    int Count();
+    Client^ GetClient(int index);
+    List<Client^>^ GetClients(); // копия списка, изменения в ней не сохраняются
     double CalculateTotalIncome();
+
+    // для таблицы: текст ячейки, общий доход и изменения с прошлого вызова
+    String^ GetCell(int row, int column);
+    String^ FormatTotalIncome();
+    List<RowChange>^ TakeChanges();
+    void SortByName();
+    // номер строки первого (по алфавиту) клиента, у которого слово имени начинается с prefix, или -1
+    int FindFirstByPrefix(String^ prefix);
+    // сортировка по столбцу таблицы (Type, Name, Rate, Amount, Income), при равенстве - по имени
+    void SortByColumn(String^ column, bool descending);
     void SaveToFile(String^ filename);
     void LoadFromFile(String^ filename);
 };
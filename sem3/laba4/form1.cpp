@@ -9,6 +9,8 @@ using namespace System::Collections::Generic;
 
 Form1::Form1() {
     bank = gcnew BankSystem();
+    sortColumn = nullptr;
+    sortDescending = false;
     InitializeComponent();
     RefreshGrid();
 }
@@ -26,6 +28,7 @@ void Form1::InitializeComponent() {
     btnLoad = gcnew Button(); btnLoad->Text = "загрузить";
     btnSave = gcnew Button(); btnSave->Text = "сохранить";
     btnSort = gcnew Button(); btnSort->Text = "сортировка";
+    txtSearch = gcnew TextBox(); txtSearch->Width = 160;
 
     // DataGridView
     dataGridView->Dock = DockStyle::Top;
@@ -38,6 +41,15 @@ void Form1::InitializeComponent() {
     dataGridView->Columns->Add("Rate", "ставка (%)");
     dataGridView->Columns->Add("Amount", "вклад");
     dataGridView->Columns->Add("Income", "доход");
+    // строки сортирует ядро, а не сама таблица: иначе номера строк разойдутся с клиентами
+    for each (DataGridViewColumn ^ col in dataGridView->Columns) {
+        col->SortMode = DataGridViewColumnSortMode::Programmatic;
+    }
+    dataGridView->ColumnHeaderMouseClick += gcnew DataGridViewCellMouseEventHandler(this, &Form1::OnColumnHeaderClick);
+    // виртуальный режим: таблица спрашивает только видимые ячейки
+    dataGridView->VirtualMode = true;
+    dataGridView->ReadOnly = true;
+    dataGridView->CellValueNeeded += gcnew DataGridViewCellValueEventHandler(this, &Form1::OnCellValueNeeded);
 
     // Total label
     lblTotal->Text = "общий доход: 0.00";
@@ -54,6 +66,8 @@ void Form1::InitializeComponent() {
     btnLoad->Click += gcnew EventHandler(this, &Form1::OnLoad);
     btnSave->Click += gcnew EventHandler(this, &Form1::OnSave);
     btnSort->Click += gcnew EventHandler(this, &Form1::OnSortByName);
+    // поиск по мере ввода: выделяется первый клиент, чьё имя (любое слово) начинается с текста
+    txtSearch->TextChanged += gcnew EventHandler(this, &Form1::OnSearchChanged);
 
     // Panel
     FlowLayoutPanel^ panel = gcnew FlowLayoutPanel();
@@ -61,7 +75,7 @@ void Form1::InitializeComponent() {
     panel->Padding = System::Windows::Forms::Padding(5);
     panel->Controls->AddRange(gcnew array<Control^>{
         btnAddSimple, btnAddVIP, btnEdit, btnDelete,
-            btnLoad, btnSave, btnSort
+            btnLoad, btnSave, btnSort, txtSearch
     });
 
     // Final layout
@@ -74,22 +88,32 @@ void Form1::InitializeComponent() {
     dataGridView->AllowUserToAddRows = false;
 }
 
+// применяет изменения из BankSystem: правка строки перерисовывает только её,
+// добавление/удаление/сортировка меняют число строк и перерисовывают видимую часть
 void Form1::RefreshGrid() {
-    dataGridView->Rows->Clear();
-    for each (Client ^ c in bank->GetClients()) {
-        dataGridView->Rows->Add(
-            c->IsVIP() ? "VIP" : "обычный",
-            c->Name,
-            c->Rate.ToString(),
-            c->Amount.ToString(),
-            c->Calculate().ToString("F2")
-        );
+    bool structural = dataGridView->RowCount != bank->Count();
+    for each (RowChange ch in bank->TakeChanges()) {
+        if (ch.Kind == RowChangeKind::Updated) {
+            if (ch.Index < dataGridView->RowCount)
+                dataGridView->InvalidateRow(ch.Index);
+        }
+        else {
+            structural = true;
+        }
+    }
+    if (structural) {
+        dataGridView->RowCount = bank->Count();
+        dataGridView->Invalidate();
     }
     UpdateTotalLabel();
 }
 
+void Form1::OnCellValueNeeded(System::Object^ sender, DataGridViewCellValueEventArgs^ e) {
+    e->Value = bank->GetCell(e->RowIndex, e->ColumnIndex);
+}
+
 void Form1::UpdateTotalLabel() {
-    lblTotal->Text = "общий доход: " + bank->CalculateTotalIncome().ToString("F2");
+    lblTotal->Text = "общий доход: " + bank->FormatTotalIncome();
 }
 
 void Form1::OnAddSimple(System::Object^ sender, System::EventArgs^ e) {
@@ -127,7 +151,7 @@ void Form1::OnEdit(System::Object^ sender, System::EventArgs^ e) {
     }
 
     int idx = dataGridView->SelectedRows[0]->Index;
-    ClientForm^ form = gcnew ClientForm(bank->GetClients()[idx]);
+    ClientForm^ form = gcnew ClientForm(bank->GetClient(idx));
 
     if (form->ShowDialog() == System::Windows::Forms::DialogResult::OK) {
         Client^ updatedClient = form->GetClient();
@@ -148,7 +172,7 @@ void Form1::OnDelete(System::Object^ sender, System::EventArgs^ e) {
 
 void Form1::OnLoad(System::Object^ sender, System::EventArgs^ e) {
     OpenFileDialog^ ofd = gcnew OpenFileDialog();
-    ofd->Filter = "CSV файлы (*.csv)|*.csv";
+    ofd->Filter = "CSV файлы (*.csv)|*.csv|колоночный формат (*.bcol)|*.bcol";
     if (ofd->ShowDialog() == System::Windows::Forms::DialogResult::OK) {
         try {
             bank->LoadFromFile(ofd->FileName);
@@ -162,7 +186,7 @@ void Form1::OnLoad(System::Object^ sender, System::EventArgs^ e) {
 
 void Form1::OnSave(System::Object^ sender, System::EventArgs^ e) {
     SaveFileDialog^ sfd = gcnew SaveFileDialog();
-    sfd->Filter = "CSV файлы (*.csv)|*.csv";
+    sfd->Filter = "CSV файлы (*.csv)|*.csv|колоночный формат (*.bcol)|*.bcol";
     sfd->DefaultExt = "csv";
     if (sfd->ShowDialog() == System::Windows::Forms::DialogResult::OK) {
         try {
@@ -176,16 +200,36 @@ void Form1::OnSave(System::Object^ sender, System::EventArgs^ e) {
 }
 
 void Form1::OnSortByName(System::Object^ sender, System::EventArgs^ e) {
-    auto list = bank->GetClients();
-    int n = list->Count;
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = i + 1; j < n; j++) {
-            if (String::Compare(list[i]->Name, list[j]->Name, true) > 0) {
-                Client^ tmp = list[i];
-                list[i] = list[j];
-                list[j] = tmp;
-            }
-        }
-    }
+    bank->SortByName();
+    sortColumn = "Name";
+    sortDescending = false;
     RefreshGrid();
+    ShowSortGlyph();
+}
+
+void Form1::OnSearchChanged(System::Object^ sender, System::EventArgs^ e) {
+    int index = bank->FindFirstByPrefix(txtSearch->Text);
+    if (index < 0) return;
+    dataGridView->ClearSelection();
+    dataGridView->Rows[index]->Selected = true;
+    dataGridView->FirstDisplayedScrollingRowIndex = index;
+}
+
+void Form1::OnColumnHeaderClick(System::Object^ sender, DataGridViewCellMouseEventArgs^ e) {
+    String^ column = dataGridView->Columns[e->ColumnIndex]->Name;
+    // повторный щелчок по тому же столбцу меняет направление
+    sortDescending = (column == sortColumn) ? !sortDescending : false;
+    sortColumn = column;
+    bank->SortByColumn(column, sortDescending);
+    RefreshGrid();
+    ShowSortGlyph();
+}
+
+void Form1::ShowSortGlyph() {
+    for each (DataGridViewColumn ^ col in dataGridView->Columns) {
+        if (col->Name == sortColumn)
+            col->HeaderCell->SortGlyphDirection = sortDescending ? SortOrder::Descending : SortOrder::Ascending;
+        else
+            col->HeaderCell->SortGlyphDirection = SortOrder::None;
+    }
 }
@@ -1,190 +1,263 @@
 // BankSystem.cpp
 #include "BankSystem.h"
-#include "sqlite3.h"
+#include "../bank_core/columnar.h"
+#include "../bank_core/sqlite_storage.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <memory>
 #include <string>
-#include <cstring>
+#include <stdexcept>
 
-BankSystem::BankSystem() {
-    clients = gcnew List<Client^>();
-}
+// с этого числа клиентов база открывается страницами (PagedClientTable), а не загружается целиком
+static const int64_t pagedThreshold = 100000;
 
-void BankSystem::AddClient(Client^ c) {
-    if (c != nullptr) clients->Add(c);
+static std::string StringToUTF8(String^ str) {
+    if (String::IsNullOrEmpty(str)) return "";
+    array<Byte>^ bytes = Encoding::UTF8->GetBytes(str);
+    pin_ptr<Byte> pinned = &bytes[0];
+    return std::string((char*)pinned, bytes->Length);
 }
 
-void BankSystem::RemoveClient(int index) {
-    if (index >= 0 && index < clients->Count)
-        clients->RemoveAt(index);
+static String^ UTF8ToString(const std::string& utf8) {
+    if (utf8.empty()) return "";
+    return gcnew String(utf8.data(), 0, (int)utf8.size(), Encoding::UTF8);
 }
 
-void BankSystem::UpdateClient(int index, Client^ c) {
-    if (index >= 0 && index < clients->Count && c != nullptr)
-        clients[index] = c;
+static core::ClientRecord ToNative(Client^ c) {
+    core::ClientRecord r;
+    r.name = StringToUTF8(c->Name);
+    r.rate = c->Rate;
+    r.vip = c->IsVIP();
+    r.amount = r.vip ? c->Amount - core::ClientRecord::VipBonus : c->Amount;
+    return r;
 }
 
-List<Client^>^ BankSystem::GetClients() {
-    return clients;
+static Client^ FromNative(const core::ClientRecord& r) {
+    String^ name = UTF8ToString(r.name);
+    if (r.vip)
+        return gcnew VIPClient(name, r.rate, r.amount);
+    return gcnew SimpleClient(name, r.rate, r.amount);
 }
 
-double BankSystem::CalculateTotalIncome() {
-    double total = 0.0;
-    for each (Client ^ c in clients) {
-        total += c->Calculate();
-    }
-    return total;
+// .bcol - колоночный формат ядра, остальное - основной формат лабы
+static bool IsColumnarFile(String^ filename) {
+    return filename->EndsWith(".bcol", StringComparison::OrdinalIgnoreCase);
 }
 
-static std::string StringToUTF8(System::String^ str) {
-    if (str == nullptr) return "";
-    array<Byte>^ bytes = Encoding::UTF8->GetBytes(str);
-    pin_ptr<Byte> pinned = &bytes[0];
-    return std::string((char*)pinned, bytes->Length);
+BankSystem::BankSystem() {
+    native = new core::BankSystem();
+    view = new core::ClientViewModel(*native);
+    names = new core::NameIndex(*native);
+    paged = nullptr;
+    pagedIncomeCents = 0;
+    pagedReset = false;
+    view->SetDecimalSeparator(StringToUTF8(
+        System::Globalization::CultureInfo::CurrentCulture->NumberFormat->NumberDecimalSeparator));
 }
 
-static System::String^ UTF8ToString(const char* utf8) {
-    if (!utf8) return "";
-    return gcnew System::String((char*)utf8, 0, (int)strlen(utf8), Encoding::UTF8);
+BankSystem::~BankSystem() {
+    this->!BankSystem();
 }
 
-void BankSystem::SaveToFile(String^ filename) {
-    // filename = путь к .db
+BankSystem::!BankSystem() {
+    ClosePaged();
+    delete names;
+    delete view;
+    delete native;
+    names = nullptr;
+    view = nullptr;
+    native = nullptr;
+}
 
-    sqlite3* db = nullptr;
-    int rc = sqlite3_open(StringToUTF8(filename).c_str(), &db);
+void BankSystem::ClosePaged() {
+    delete paged;
+    paged = nullptr;
+    pagedFile = nullptr;
+    pagedIncomeCents = 0;
+}
 
-    if (rc != SQLITE_OK) {
-        String^ msg = "не удалось создать/открыть базу: " + filename + "\n" + UTF8ToString(sqlite3_errmsg(db));
-        sqlite3_close(db);
-        throw gcnew Exception(msg);
+// порядок строк тот же (ORDER BY id), поэтому номера строк в таблице формы остаются верными
+void BankSystem::EnsureLoaded() {
+    if (paged == nullptr) return;
+    std::string path = StringToUTF8(pagedFile);
+    std::string error;
+    try {
+        core::LoadFromDatabase(*native, path);
     }
-
-    // Таблица клиентов
-    const char* createTableSQL = R"(
-        CREATE TABLE IF NOT EXISTS Clients (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            is_vip INTEGER NOT NULL,
-            name TEXT NOT NULL,
-            rate INTEGER NOT NULL,
-            amount_base INTEGER NOT NULL
-        );
-    )";
-
-    rc = sqlite3_exec(db, createTableSQL, nullptr, nullptr, nullptr);
-    if (rc != SQLITE_OK) {
-        String^ msg = "ошибка создания таблицы: " + UTF8ToString(sqlite3_errmsg(db));
-        sqlite3_close(db);
-        throw gcnew Exception(msg);
+    catch (const std::exception& e) {
+        error = e.what();
     }
+    if (!error.empty()) throw gcnew Exception(UTF8ToString(error));
+    ClosePaged();
+}
 
-    // как в примере: чистим старое
-    sqlite3_exec(db, "DELETE FROM Clients;", nullptr, nullptr, nullptr);
+void BankSystem::AddClient(Client^ c) {
+    if (c == nullptr) return;
+    EnsureLoaded();
+    native->AddClient(ToNative(c));
+}
 
-    const char* insertSQL =
-        "INSERT INTO Clients (is_vip, name, rate, amount_base) VALUES (?, ?, ?, ?);";
+void BankSystem::RemoveClient(int index) {
+    EnsureLoaded();
+    native->RemoveClient(index);
+}
 
-    sqlite3_stmt* stmt = nullptr;
-    rc = sqlite3_prepare_v2(db, insertSQL, -1, &stmt, nullptr);
+void BankSystem::UpdateClient(int index, Client^ c) {
+    if (c == nullptr) return;
+    EnsureLoaded();
+    native->UpdateClient(index, ToNative(c));
+}
 
-    if (rc != SQLITE_OK) {
-        String^ msg = "ошибка подготовки запроса: " + UTF8ToString(sqlite3_errmsg(db));
-        sqlite3_close(db);
-        throw gcnew Exception(msg);
-    }
+int BankSystem::Count() {
+    if (paged != nullptr) return static_cast<int>(std::min<int64_t>(paged->Count(), INT_MAX));
+    return native->Count();
+}
 
+Client^ BankSystem::GetClient(int index) {
+    if (index < 0 || index >= Count()) return nullptr;
+    if (paged == nullptr) return FromNative(native->GetClient(index));
+    core::ClientRecord r;
     try {
-        for each (Client ^ c in clients) {
-            int isVip = c->IsVIP() ? 1 : 0;
+        r = paged->Get(index);
+    }
+    catch (const std::exception&) {
+        return nullptr; // база изменилась после открытия
+    }
+    return FromNative(r);
+}
 
-            // ВАЖНО: в БД кладём "чистую" сумму, без +1000
-            int amountBase = isVip ? (c->Amount - 1000) : c->Amount;
+List<Client^>^ BankSystem::GetClients() {
+    EnsureLoaded();
+    List<Client^>^ list = gcnew List<Client^>(native->Count());
+    for (const auto& r : native->GetClients()) {
+        list->Add(FromNative(r));
+    }
+    return list;
+}
 
-            sqlite3_bind_int(stmt, 1, isVip);
-            sqlite3_bind_text(stmt, 2, StringToUTF8(c->Name).c_str(), -1, SQLITE_TRANSIENT);
-            sqlite3_bind_int(stmt, 3, c->Rate);
-            sqlite3_bind_int(stmt, 4, amountBase);
+// итог ведёт модель представления, пересчёт всех клиентов не нужен
+double BankSystem::CalculateTotalIncome() {
+    if (paged != nullptr) return pagedIncomeCents / 100.0;
+    return view->TotalIncome();
+}
 
-            rc = sqlite3_step(stmt);
-            if (rc != SQLITE_DONE) {
-                throw gcnew Exception("ошибка вставки клиента: " + UTF8ToString(sqlite3_errmsg(db)));
-            }
+int BankSystem::FindFirstByPrefix(String^ prefix) {
+    if (String::IsNullOrWhiteSpace(prefix)) return -1;
+    EnsureLoaded(); // индексу имён нужны все клиенты
+    std::vector<core::ClientHandle> found = names->FindPrefix(StringToUTF8(prefix->Trim()), 1);
+    return found.empty() ? -1 : native->IndexOf(found[0]);
+}
 
-            sqlite3_reset(stmt);
-            sqlite3_clear_bindings(stmt);
-        }
+String^ BankSystem::GetCell(int row, int column) {
+    if (paged == nullptr) return UTF8ToString(view->GetCell(row, column));
+    if (row < 0 || row >= Count()) return "";
+    std::string text;
+    try {
+        text = core::ClientViewModel::FormatCell(paged->Get(row), column, view->DecimalSeparator());
     }
-    catch (Exception^) {
-        sqlite3_finalize(stmt);
-        sqlite3_close(db);
-        throw;
+    catch (const std::exception&) {
+        return ""; // база изменилась после открытия
     }
-
-    sqlite3_finalize(stmt);
-    sqlite3_close(db);
+    return UTF8ToString(text);
 }
 
-void BankSystem::LoadFromFile(String^ filename) {
-    clients->Clear();
-
-    sqlite3* db = nullptr;
-    int rc = sqlite3_open(StringToUTF8(filename).c_str(), &db);
+String^ BankSystem::FormatTotalIncome() {
+    if (paged != nullptr)
+        return UTF8ToString(core::ClientViewModel::FormatCents(pagedIncomeCents, view->DecimalSeparator()));
+    return UTF8ToString(view->FormatTotalIncome());
+}
 
-    if (rc != SQLITE_OK) {
-        String^ msg = "не удалось открыть базу: " + filename + "\n" + UTF8ToString(sqlite3_errmsg(db));
-        sqlite3_close(db);
-        throw gcnew Exception(msg);
+List<RowChange>^ BankSystem::TakeChanges() {
+    std::vector<core::RowChange> changes = view->TakeChanges();
+    if (pagedReset) {
+        changes.assign(1, core::RowChange{ core::RowChangeKind::Reset, 0 });
+        pagedReset = false;
     }
-
-    // на всякий случай создадим таблицу
-    const char* createTableSQL = R"(
-        CREATE TABLE IF NOT EXISTS Clients (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            is_vip INTEGER NOT NULL,
-            name TEXT NOT NULL,
-            rate INTEGER NOT NULL,
-            amount_base INTEGER NOT NULL
-        );
-    )";
-
-    rc = sqlite3_exec(db, createTableSQL, nullptr, nullptr, nullptr);
-    if (rc != SQLITE_OK) {
-        String^ msg = "ошибка создания таблицы: " + UTF8ToString(sqlite3_errmsg(db));
-        sqlite3_close(db);
-        throw gcnew Exception(msg);
+    List<RowChange>^ list = gcnew List<RowChange>();
+    for (const auto& ch : changes) {
+        RowChange rc;
+        rc.Index = ch.index;
+        switch (ch.kind) {
+        case core::RowChangeKind::Inserted: rc.Kind = RowChangeKind::Inserted; break;
+        case core::RowChangeKind::Updated:  rc.Kind = RowChangeKind::Updated; break;
+        case core::RowChangeKind::Removed:  rc.Kind = RowChangeKind::Removed; break;
+        default:                            rc.Kind = RowChangeKind::Reset; break;
+        }
+        list->Add(rc);
     }
+    return list;
+}
 
-    const char* selectSQL =
-        "SELECT is_vip, name, rate, amount_base FROM Clients ORDER BY id;";
+void BankSystem::SortByName() {
+    EnsureLoaded();
+    native->SortByName();
+}
 
-    sqlite3_stmt* stmt = nullptr;
-    rc = sqlite3_prepare_v2(db, selectSQL, -1, &stmt, nullptr);
+void BankSystem::SortByColumn(String^ column, bool descending) {
+    EnsureLoaded();
+    core::SortField field = core::SortField::Name;
+    if (column == "Type") field = core::SortField::Type;
+    else if (column == "Rate") field = core::SortField::Rate;
+    else if (column == "Amount") field = core::SortField::Amount;
+    else if (column == "Income") field = core::SortField::Income;
+
+    std::vector<core::SortKey> keys;
+    keys.push_back({ field, descending });
+    if (field != core::SortField::Name)
+        keys.push_back({ core::SortField::Name, false });
+    native->Sort(keys);
+}
 
-    if (rc != SQLITE_OK) {
-        String^ msg = "ошибка запроса к базе: " + UTF8ToString(sqlite3_errmsg(db));
-        sqlite3_close(db);
-        throw gcnew Exception(msg);
+// ошибки ядра приходят как std::exception, формы ловят Exception^
+// filename = путь к .db (или .bcol)
+void BankSystem::SaveToFile(String^ filename) {
+    EnsureLoaded();
+    bool columnar = IsColumnarFile(filename);
+    std::string path = StringToUTF8(filename);
+    std::string error;
+    try {
+        if (columnar)
+            core::SaveToColumnar(*native, path);
+        else
+            core::SaveToDatabase(*native, path);
     }
+    catch (const std::exception& e) {
+        error = e.what();
+    }
+    if (!error.empty()) throw gcnew Exception(UTF8ToString(error));
+}
 
+void BankSystem::LoadFromFile(String^ filename) {
+    bool columnar = IsColumnarFile(filename);
+    std::string path = StringToUTF8(filename);
+    std::string error;
     try {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            int isVip = sqlite3_column_int(stmt, 0);
-            const char* nameUtf8 = (const char*)sqlite3_column_text(stmt, 1);
-            int rate = sqlite3_column_int(stmt, 2);
-            int amountBase = sqlite3_column_int(stmt, 3);
-
-            String^ name = UTF8ToString(nameUtf8);
-
-            if (isVip)
-                AddClient(gcnew VIPClient(name, rate, amountBase));
-            else
-                AddClient(gcnew SimpleClient(name, rate, amountBase));
+        if (columnar) {
+            core::LoadFromColumnar(*native, path);
+            ClosePaged();
+        }
+        else {
+            // большую базу не загружаем: число строк известно сразу, страницы читаются по мере прокрутки
+            std::unique_ptr<core::PagedClientTable> table(new core::PagedClientTable(path));
+            if (table->Count() >= pagedThreshold) {
+                core::IncomeSummary s = core::SummarizeDatabase(path);
+                native->Assign({}); // прежние клиенты освобождаются
+                ClosePaged();
+                paged = table.release();
+                pagedFile = filename;
+                pagedIncomeCents = static_cast<int64_t>(std::llround(s.totalIncome * 100.0));
+                pagedReset = true;
+            }
+            else {
+                table.reset();
+                core::LoadFromDatabase(*native, path);
+                ClosePaged();
+            }
         }
     }
-    catch (Exception^) {
-        sqlite3_finalize(stmt);
-        sqlite3_close(db);
-        throw;
+    catch (const std::exception& e) {
+        error = e.what();
     }
-
-    sqlite3_finalize(stmt);
-    sqlite3_close(db);
+    if (!error.empty()) throw gcnew Exception(UTF8ToString(error));
 }
@@ -21,6 +21,10 @@ private:
     Button^ btnLoad;
     Button^ btnSave;
     Button^ btnSort;
+    TextBox^ txtSearch;
+
+    String^ sortColumn;   // столбец последней сортировки по заголовку
+    bool sortDescending;
 
     // Только объявления методов — без тел!
     void InitializeComponent();
@@ -35,6 +39,10 @@ private:
     void OnLoad(System::Object^ sender, System::EventArgs^ e);
     void OnSave(System::Object^ sender, System::EventArgs^ e);
     void OnSortByName(System::Object^ sender, System::EventArgs^ e);
+    void OnSearchChanged(System::Object^ sender, System::EventArgs^ e);
+    void OnColumnHeaderClick(System::Object^ sender, DataGridViewCellMouseEventArgs^ e);
+    void OnCellValueNeeded(System::Object^ sender, DataGridViewCellValueEventArgs^ e);
+    void ShowSortGlyph();
 
 public:
     Form1(); // только объявление конструктора